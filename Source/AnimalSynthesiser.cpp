@@ -0,0 +1,202 @@
+#include "AnimalSynthesiser.h"
+#include "RealtimeSafety.h"
+
+
+AnimalSynthesiser::AnimalSynthesiser()
+{
+    addSound(new AnimalSound());
+    setNoteStealingEnabled(true);
+
+    // MIDI is scheduled by the processor's BlockScheduler, but if renderNextBlock is ever
+    // called with MIDI directly it should be just as sample-accurate
+    setMinimumRenderingSubdivisionSize(1, true);
+}
+
+/**
+ * @brief (Re)builds the voice pool. Only call this from prepareToPlay, it allocates.
+ *
+ * @param sampleRate The current sample rate
+ * @param maximumBlockSize The largest block the host will ask for
+ * @param numChannels Number of output channels
+ * @param numberOfVoices Size of the voice pool, clamped to [VoicePool::minVoices, VoicePool::maxVoices]
+ * @param numberOfWorkers Render threads besides the audio thread, 0 renders everything on the audio thread
+ * @param parameters The processor's per-block parameter snapshot, read by every voice
+ */
+void AnimalSynthesiser::prepare(double sampleRate, int maximumBlockSize, int numChannels, int numberOfVoices,
+                                int numberOfWorkers, const VoiceParameters& parameters)
+{
+    renderPool.release();
+    pool.prepare(numberOfVoices, sampleRate, maximumBlockSize);
+
+    clearVoices();
+    animalVoices.clear();
+    animalVoices.reserve(static_cast<size_t>(pool.size()));
+    activeVoices.clear();
+    activeVoices.reserve(static_cast<size_t>(pool.size()));
+
+    for (int i = 0; i < pool.size(); ++i)
+    {
+        auto* voice = new AnimalVoice(pool, i, parameters);
+        addVoice(voice);
+        animalVoices.push_back(voice);
+    }
+
+    setCurrentPlaybackSampleRate(sampleRate);
+
+    renderPool.prepare(numberOfWorkers, numChannels, maximumBlockSize);
+}
+
+/**
+ * @brief Applies a single MIDI message. The processor's BlockScheduler calls this at the message's exact sample.
+ */
+void AnimalSynthesiser::handleMidi(const juce::MidiMessage& message)
+{
+    // juce::Synthesiser takes its CriticalSection for every note and controller. It is never contended:
+    // only the audio thread calls into the synth while playing, the render workers only touch voices.
+    // prepare() takes it too, but the host never runs that concurrently with processBlock.
+    // Only the lock is allowed, anything the synth allocates in here is still reported
+    ANIMALSYNTH_REALTIME_ALLOW_LOCKS
+
+    handleMidiEvent(message);
+}
+
+/**
+ * @brief Renders all voices for a stretch of the block that contains no events.
+ *
+ * MIDI is fed separately through handleMidi() at the exact sample it belongs to.
+ *
+ * @param outputAudio the buffer all voices are summed into
+ * @param startSample first sample to render
+ * @param numSamples number of samples to render
+ */
+void AnimalSynthesiser::renderRange(juce::AudioBuffer<float>& outputAudio, int startSample, int numSamples)
+{
+    if (numSamples > 0)
+        renderVoices(outputAudio, startSample, numSamples);
+}
+
+void AnimalSynthesiser::renderRange(juce::AudioBuffer<double>& outputAudio, int startSample, int numSamples)
+{
+    if (numSamples > 0)
+        renderVoices(outputAudio, startSample, numSamples);
+}
+
+/**
+ * @brief Stops the render threads, e.g. from releaseResources. prepare() starts them again.
+ */
+void AnimalSynthesiser::releaseWorkers()
+{
+    renderPool.release();
+}
+
+/**
+ * @brief Updates the per-block worker utilisation.
+ *
+ * @param blockTicks How long renderNextBlock took for the whole block, in high resolution ticks
+ */
+void AnimalSynthesiser::publishRenderStats(juce::int64 blockTicks) noexcept
+{
+    renderPool.publishUtilisation(blockTicks);
+}
+
+/**
+ *
+ * @return The loudest envelope of all sounding voices. Used to drive the animations
+ */
+float AnimalSynthesiser::getEnvelopeLevel() const noexcept
+{
+    float level = 0.0f;
+
+    for (auto* voice : animalVoices)
+        level = juce::jmax(level, voice->getCurrentLevel());
+
+    return level;
+}
+
+int AnimalSynthesiser::getNumActiveVoices() const noexcept
+{
+    int active = 0;
+
+    for (auto* voice : animalVoices)
+        if (voice->isVoiceActive())
+            ++active;
+
+    return active;
+}
+
+/**
+ * @brief Renders all sounding voices, spread across the render threads if that is worth it.
+ *
+ * The voices' scratch buffers only hold the block size the pool was prepared for,
+ * so longer ranges are rendered in chunks of at most that size.
+ */
+template <typename SampleType>
+void AnimalSynthesiser::renderActiveVoices(juce::AudioBuffer<SampleType>& outputAudio, int startSample, int numSamples)
+{
+    const int maxChunk = juce::jmax(1, pool.getMaximumBlockSize());
+    const int endSample = startSample + numSamples;
+
+    for (int start = startSample; start < endSample; start += maxChunk)
+    {
+        const int length = juce::jmin(maxChunk, endSample - start);
+
+        // Collected per chunk, a voice may have finished in the previous one
+        activeVoices.clear();
+
+        for (auto* voice : animalVoices)
+            if (voice->isVoiceActive())
+                activeVoices.push_back(voice);
+
+        const int numActive = static_cast<int>(activeVoices.size());
+
+        if (numActive >= minVoicesForThreading && length >= minSamplesForThreading
+            && renderPool.canRender(outputAudio, start, length))
+        {
+            renderPool.render(activeVoices.data(), numActive, outputAudio, start, length);
+            continue;
+        }
+
+        for (auto* voice : activeVoices)
+            voice->renderNextBlock(outputAudio, start, length);
+    }
+}
+
+void AnimalSynthesiser::renderVoices(juce::AudioBuffer<float>& outputAudio, int startSample, int numSamples)
+{
+    renderActiveVoices(outputAudio, startSample, numSamples);
+}
+
+void AnimalSynthesiser::renderVoices(juce::AudioBuffer<double>& outputAudio, int startSample, int numSamples)
+{
+    renderActiveVoices(outputAudio, startSample, numSamples);
+}
+
+/**
+ * @brief Chooses the voice to cut off when the pool is full.
+ *
+ * Released voices are fading out anyway, so the quietest of those goes first.
+ * Only if every voice is still held the oldest note is sacrificed.
+ */
+juce::SynthesiserVoice* AnimalSynthesiser::findVoiceToSteal(juce::SynthesiserSound* soundToPlay, int, int) const
+{
+    AnimalVoice* quietestReleased = nullptr;
+    AnimalVoice* oldest = nullptr;
+
+    for (auto* voice : animalVoices)
+    {
+        if (!voice->canPlaySound(soundToPlay))
+            continue;
+
+        if (voice->isPlayingButReleased())
+        {
+            if (quietestReleased == nullptr || voice->getCurrentLevel() < quietestReleased->getCurrentLevel())
+                quietestReleased = voice;
+        }
+        else if (oldest == nullptr || voice->wasStartedBefore(*oldest))
+        {
+            oldest = voice;
+        }
+    }
+
+    return quietestReleased != nullptr ? quietestReleased : oldest;
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <juce_audio_basics/juce_audio_basics.h>
+
+#include "AnimalVoice.h"
+#include "VoicePool.h"
+#include "VoiceRenderPool.h"
+
+
+/**
+ * @brief Polyphonic engine with a fixed, preallocated pool of AnimalVoices
+ *
+ * When every voice is busy, a new note steals the quietest voice that has already been released.
+ * If all voices are still held down, the oldest one is taken instead.
+ *
+ * Optionally the voices are rendered on a VoiceRenderPool. Small blocks and low voice counts
+ * are always rendered on the audio thread, where the dispatch overhead would outweigh the gain.
+ */
+class AnimalSynthesiser : public juce::Synthesiser
+{
+public:
+    AnimalSynthesiser();
+
+    /// Below these sizes voices are rendered on the audio thread even if workers are running
+    static constexpr int minVoicesForThreading = 4;
+    static constexpr int minSamplesForThreading = 64;
+
+    void prepare(double sampleRate, int maximumBlockSize, int numChannels, int numberOfVoices,
+                 int numberOfWorkers, const VoiceParameters& parameters);
+    void releaseWorkers();
+
+    void handleMidi(const juce::MidiMessage& message);
+    void renderRange(juce::AudioBuffer<float>& outputAudio, int startSample, int numSamples);
+    void renderRange(juce::AudioBuffer<double>& outputAudio, int startSample, int numSamples);
+
+    void publishRenderStats(juce::int64 blockTicks) noexcept;
+    int getNumWorkers() const noexcept { return renderPool.getNumWorkers(); }
+    float getWorkerUtilisation(int worker) const noexcept { return renderPool.getWorkerUtilisation(worker); }
+
+    float getEnvelopeLevel() const noexcept;
+    int getNumActiveVoices() const noexcept;
+
+protected:
+    using juce::Synthesiser::renderVoices;
+    void renderVoices(juce::AudioBuffer<float>& outputAudio, int startSample, int numSamples) override;
+    void renderVoices(juce::AudioBuffer<double>& outputAudio, int startSample, int numSamples) override;
+    juce::SynthesiserVoice* findVoiceToSteal(juce::SynthesiserSound* soundToPlay, int midiChannel, int midiNoteNumber) const override;
+
+private:
+    template <typename SampleType>
+    void renderActiveVoices(juce::AudioBuffer<SampleType>& outputAudio, int startSample, int numSamples);
+
+    VoicePool pool;
+    std::vector<AnimalVoice*> animalVoices;
+    std::vector<juce::SynthesiserVoice*> activeVoices;
+
+    VoiceRenderPool renderPool;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AnimalSynthesiser)
+};
@@ -0,0 +1,521 @@
+#include "AnimalVoice.h"
+
+#include <type_traits>
+
+
+AnimalVoice::AnimalVoice(VoicePool& voicePool, int voiceIndex, const VoiceParameters& voiceParameters)
+    : pool(voicePool), index(voiceIndex), params(voiceParameters)
+{
+}
+
+bool AnimalVoice::canPlaySound(juce::SynthesiserSound* sound)
+{
+    return dynamic_cast<AnimalSound*>(sound) != nullptr;
+}
+
+/**
+ * @brief Picks the animal for this note and starts its envelopes.
+ *
+ * @param midiNoteNumber The note to be played
+ * @param velocity unused, the animals don't care how hard you hit the keys
+ * @param sound the AnimalSound
+ * @param currentPitchWheelPosition unused
+ */
+void AnimalVoice::startNote(int midiNoteNumber, float, juce::SynthesiserSound*, int)
+{
+    const auto v = static_cast<size_t>(index);
+    const double sampleRate = getSampleRate();
+    const double freq = juce::MidiMessage::getMidiNoteInHertz(midiNoteNumber);
+
+    auto& voice = pool.common[v];
+    voice.waveform = params.waveform;
+    voice.phaseIncrement = freq / sampleRate;
+
+    switch (static_cast<WaveformType>(voice.waveform))
+    {
+        case WaveformType::Sine:
+        {
+            pool.sine[v].filterEnvIncrement = 1.0f / static_cast<float>(sampleRate * 0.25); // ~250ms decay
+            break;
+        }
+        case WaveformType::Saw:
+            break;
+        case WaveformType::Square:
+        {
+            auto& square = pool.square[v];
+            square.punchLevel = 1.0f;
+
+            // Start the bark envelope only on note-on
+            square.barkEnvelope = 1.0f;
+            square.barkDecayRate = 1.0f / static_cast<float>(sampleRate * 0.15);
+            break;
+        }
+        case WaveformType::Triangle:
+        {
+            // === Pitch Glide ===
+            auto& triangle = pool.triangle[v];
+            const double startFreq = freq * std::pow(2.0, -params.glideDepth / 12.0);
+
+            triangle.glideTargetFreq  = freq;
+            triangle.glideCurrentFreq = startFreq;
+            triangle.glideSamplesLeft = static_cast<int>(params.glideTime * sampleRate);
+            triangle.glideStep        = (triangle.glideSamplesLeft > 0) ? (freq - startFreq) / triangle.glideSamplesLeft : 0.0;
+            break;
+        }
+    }
+
+    voice.adsr.setParameters(params.adsr);
+    voice.adsr.noteOn();
+}
+
+void AnimalVoice::stopNote(float, bool allowTailOff)
+{
+    if (allowTailOff)
+    {
+        pool.common[static_cast<size_t>(index)].adsr.noteOff();
+    }
+    else
+    {
+        pool.resetVoice(index);
+        clearCurrentNote();
+    }
+}
+
+/**
+ * @brief Renders the voice in mono and adds it to every channel of the output.
+ *
+ * @param outputBuffer the buffer all voices are summed into
+ * @param startSample first sample to render
+ * @param numSamples number of samples to render
+ */
+template <typename SampleType>
+void AnimalVoice::renderInto(juce::AudioBuffer<SampleType>& outputBuffer, int startSample, int numSamples)
+{
+    if (!isVoiceActive())
+        return;
+
+    // The scratch buffer holds one prepared block, AnimalSynthesiser splits anything longer
+    jassert(numSamples <= pool.getMaximumBlockSize());
+
+    auto& voice = pool.common[static_cast<size_t>(index)];
+    voice.adsr.setParameters(params.adsr);
+
+    switch (static_cast<WaveformType>(voice.waveform))
+    {
+        case WaveformType::Sine: renderSine(startSample, numSamples); break;
+        case WaveformType::Saw: renderSaw(startSample, numSamples); break;
+        case WaveformType::Square: renderSquare(startSample, numSamples); break;
+        case WaveformType::Triangle: renderTriangle(startSample, numSamples); break;
+    }
+
+    for (int channel = 0; channel < outputBuffer.getNumChannels(); ++channel)
+    {
+        if constexpr (std::is_same_v<SampleType, float>)
+        {
+            outputBuffer.addFrom(channel, startSample, voice.scratch, numSamples);
+        }
+        else
+        {
+            SampleType* output = outputBuffer.getWritePointer(channel, startSample);
+
+            for (int sample = 0; sample < numSamples; ++sample)
+                output[sample] += static_cast<SampleType>(voice.scratch[sample]);
+        }
+    }
+
+    if (!voice.adsr.isActive())
+    {
+        pool.resetVoice(index);
+        clearCurrentNote();
+    }
+}
+
+void AnimalVoice::renderNextBlock(juce::AudioBuffer<float>& outputBuffer, int startSample, int numSamples)
+{
+    renderInto(outputBuffer, startSample, numSamples);
+}
+
+void AnimalVoice::renderNextBlock(juce::AudioBuffer<double>& outputBuffer, int startSample, int numSamples)
+{
+    renderInto(outputBuffer, startSample, numSamples);
+}
+
+/**
+ *
+ * @return The last envelope value of this voice, 0 if it is idle
+ */
+float AnimalVoice::getCurrentLevel() const noexcept
+{
+    return isVoiceActive() ? pool.common[static_cast<size_t>(index)].level : 0.0f;
+}
+
+/**
+ * @brief Creates the "Howl" sound using a Sine Wave and Effects
+ * @param startSample position of the first sample inside the host block, used to index the parameter ramps
+ * @param numSamples number of samples to render into the scratch buffer
+ */
+void AnimalVoice::renderSine(int startSample, int numSamples)
+{
+    auto& voice = pool.common[static_cast<size_t>(index)];
+    auto& sine = pool.sine[static_cast<size_t>(index)];
+    const double sampleRate = getSampleRate();
+    const WavetableBank* wavetables = params.engine == OscillatorEngine::Wavetable ? pool.wavetables.get() : nullptr;
+
+    // === Vibrato and Tremolo LFOs, one block at a time ===
+    float* vibrato = voice.modulation;
+    float* tremolo = voice.modulation + pool.getMaximumBlockSize();
+    Lfo::renderSine(vibrato, sine.vibratoPhase, params.vibratoRate, params.vibratoDepth, startSample, numSamples, sampleRate);
+    Lfo::renderSine(tremolo, sine.tremoloPhase, params.tremoloRate, params.tremoloDepth, startSample, numSamples, sampleRate);
+
+    for (int sample = 0; sample < numSamples; ++sample)
+    {
+        float env = voice.adsr.getNextSample();
+        voice.level = env;
+
+        double modulatedPhaseInc = voice.phaseIncrement * (1.0 + vibrato[sample]);
+        float tremoloGain = 1.0f - tremolo[sample];
+
+        // === Sine Generation ===
+        float rawSine = wavetables != nullptr ? wavetables->sin(voice.phase)
+                                              : static_cast<float>(std::sin(2.0 * juce::MathConstants<double>::pi * voice.phase));
+        voice.phase += modulatedPhaseInc;
+        if (voice.phase >= 1.0)
+            voice.phase -= 1.0;
+
+        // === Filter Envelope ===
+        if (sine.filterEnvelope > 0.0f)
+        {
+            sine.filterEnvelope -= sine.filterEnvIncrement;
+            if (sine.filterEnvelope < 0.0f)
+                sine.filterEnvelope = 0.0f;
+        }
+
+        float cutoff = 300.0f + sine.filterEnvelope * 4000.0f;
+        sine.filter.setCutoffFrequency(cutoff);
+        float filtered = sine.filter.processSample(rawSine);
+
+        voice.scratch[sample] = filtered * env * tremoloGain;
+    }
+}
+
+/**
+ * @brief Creates the "Growl" sound using a Saw Wave and Effects
+ *
+ * Oscillator and formant filter, waveshaper and comb run as three passes over the block, so the
+ * waveshaper alone can run oversampled.
+ *
+ * @param startSample position of the first sample inside the host block, used to index the parameter ramps
+ * @param numSamples number of samples to render into the scratch buffer
+ */
+void AnimalVoice::renderSaw(int startSample, int numSamples)
+{
+    auto& voice = pool.common[static_cast<size_t>(index)];
+    auto& saw = pool.saw[static_cast<size_t>(index)];
+    auto& blep = pool.blep[static_cast<size_t>(index)];
+    auto& oversampler = pool.oversampler[static_cast<size_t>(index)];
+    const double sampleRate = getSampleRate();
+    const auto antialiasing = params.antialiasing;
+    const WavetableBank* wavetables = params.engine == OscillatorEngine::Wavetable ? pool.wavetables.get() : nullptr;
+    const int octave = wavetables != nullptr ? wavetables->getOctave(voice.phaseIncrement) : 0;
+
+    const double samplesPerMs = sampleRate / 1000.0;
+    const double maxDelaySamples = saw.comb.getMaximumDelay();
+
+    for (int sample = 0; sample < numSamples; ++sample)
+    {
+        const int i = startSample + sample;
+        const float formantRes = params.formantResonance[i];
+
+        float env = voice.adsr.getNextSample();
+        voice.level = env;
+
+        float rawSaw = 0.0f;
+
+        if (wavetables != nullptr)
+            rawSaw = wavetables->read(WavetableBank::saw, octave, voice.phase);
+        else switch (antialiasing)
+        {
+            case AntialiasingMode::Naive:    rawSaw = 2.0f * static_cast<float>(voice.phase) - 1.0f; break;
+            case AntialiasingMode::PolyBlep: rawSaw = PolyBlep::saw(voice.phase, voice.phaseIncrement); break;
+            case AntialiasingMode::MinBlep:  rawSaw = 2.0f * static_cast<float>(voice.phase) - 1.0f + blep.next(); break;
+        }
+
+        float shaped = rawSaw * env;
+
+        // === Formant Filter ===
+        if (formantRes > 0.0f)
+        {
+            // Only recalculates the coefficients while one of the formant knobs is moving
+            saw.formantFilter.setParameters(params.formantFreq[i], formantRes);
+
+            float filtered = saw.formantFilter.processSample(shaped);
+            shaped = filtered * env;
+        }
+
+        voice.scratch[sample] = shaped;
+
+        voice.phase += voice.phaseIncrement;
+        if (voice.phase >= 1.0)
+        {
+            voice.phase -= 1.0;
+
+            if (wavetables == nullptr && antialiasing == AntialiasingMode::MinBlep)
+                blep.addStep(-2.0f, voice.phase / voice.phaseIncrement);
+        }
+    }
+
+    // === Waveshaping ===
+    // Runs oversampled, so the harmonics it adds above the base Nyquist are filtered out instead of folding back.
+    // At the lowest drive it does nothing and is skipped
+    if (params.drive.ramping || params.drive.constant > 0.9f)
+    {
+        const auto& waveshaper = Waveshaper::getInstance();
+        oversampler.setup(params.oversamplingFactor, params.oversamplingQuality);
+
+        const int factor = oversampler.getFactor();
+        float* oversampled = oversampler.upsample(voice.scratch, numSamples);
+
+        if (!params.drive.ramping && !params.shape.ramping)
+        {
+            waveshaper.process(params.curve, oversampled, numSamples * factor, params.drive.constant, params.shape.constant);
+        }
+        else
+        {
+            // While Drive or Shape moves, every base rate sample gets its own values
+            for (int sample = 0; sample < numSamples; ++sample)
+            {
+                const int i = startSample + sample;
+                const float drive = params.drive[i];
+                const float shape = params.shape[i];
+
+                if (drive > 0.9f)
+                    for (float* x = oversampled + sample * factor; x < oversampled + (sample + 1) * factor; ++x)
+                        *x = waveshaper.processSample(params.curve, *x, drive, shape);
+            }
+        }
+
+        oversampler.downsample(voice.scratch, numSamples);
+
+        // The tube curve is asymmetric and leaves an offset that follows the envelope
+        if (params.curve == WaveshaperCurve::Tube)
+        {
+            const double pole = 1.0 - juce::MathConstants<double>::twoPi * 20.0 / sampleRate;
+
+            for (int sample = 0; sample < numSamples; ++sample)
+            {
+                const double input = voice.scratch[sample];
+                saw.dcBlockerOutput = input - saw.dcBlockerInput + pole * saw.dcBlockerOutput;
+                saw.dcBlockerInput = input;
+                voice.scratch[sample] = static_cast<float>(saw.dcBlockerOutput);
+            }
+        }
+    }
+
+    // === Comb Filter ===
+    // The delay follows the smoothed comb time sample by sample, so moving the knob sweeps instead of jumping.
+    // Lagrange keeps the feedback loop from dulling the sound at fractional delays, double keeps it from adding noise
+    for (int sample = 0; sample < numSamples; ++sample)
+    {
+        const int i = startSample + sample;
+        const double delaySamples = juce::jlimit(2.0, maxDelaySamples, params.combTimeMs[i] * samplesPerMs);
+
+        double delayed = saw.comb.read<DelayInterpolation::Lagrange>(delaySamples);
+        double processed = voice.scratch[sample] + delayed * params.combFeedback[i];
+
+        voice.scratch[sample] = static_cast<float>(processed);
+        saw.comb.push(processed);
+    }
+}
+
+/**
+ * @brief Creates the "Bark" sound using a Square Wave and Effects
+ *
+ * Like the saw, rendered in three passes so the bitcrusher can run oversampled.
+ *
+ * @param startSample position of the first sample inside the host block, used to index the parameter ramps
+ * @param numSamples number of samples to render into the scratch buffer
+ */
+void AnimalVoice::renderSquare(int startSample, int numSamples)
+{
+    auto& voice = pool.common[static_cast<size_t>(index)];
+    auto& square = pool.square[static_cast<size_t>(index)];
+    auto& blep = pool.blep[static_cast<size_t>(index)];
+    auto& oversampler = pool.oversampler[static_cast<size_t>(index)];
+    const double sampleRate = getSampleRate();
+    const auto antialiasing = params.antialiasing;
+    const WavetableBank* wavetables = params.engine == OscillatorEngine::Wavetable ? pool.wavetables.get() : nullptr;
+    const int octave = wavetables != nullptr ? wavetables->getOctave(voice.phaseIncrement) : 0;
+
+    const float crushRate = params.bitcrushRate;
+    const float crushDepth = params.bitcrushDepth;
+
+    for (int sample = 0; sample < numSamples; ++sample)
+    {
+        float env = voice.adsr.getNextSample();
+        voice.level = env;
+        float rawSample = 0.0f;
+
+        if (wavetables != nullptr)
+            rawSample = wavetables->read(WavetableBank::square, octave, voice.phase);
+        else switch (antialiasing)
+        {
+            case AntialiasingMode::Naive:    rawSample = (voice.phase < 0.5f) ? 1.0f : -1.0f; break;
+            case AntialiasingMode::PolyBlep: rawSample = PolyBlep::square(voice.phase, voice.phaseIncrement); break;
+            case AntialiasingMode::MinBlep:  rawSample = ((voice.phase < 0.5f) ? 1.0f : -1.0f) + blep.next(); break;
+        }
+
+        // === Punch Envelope ===
+        if (square.punchLevel > 0.0f)
+        {
+            square.punchLevel -= square.punchDecayRate;
+            if (square.punchLevel < 0.0f)
+                square.punchLevel = 0.0f;
+        }
+        float punchEnv = 1.0f + square.punchLevel;
+
+        voice.scratch[sample] = rawSample * env * punchEnv;
+
+        const double previousPhase = voice.phase;
+        voice.phase += voice.phaseIncrement;
+
+        if (wavetables == nullptr && antialiasing == AntialiasingMode::MinBlep && previousPhase < 0.5 && voice.phase >= 0.5)
+            blep.addStep(-2.0f, (voice.phase - 0.5) / voice.phaseIncrement);
+
+        if (voice.phase >= 1.0)
+        {
+            voice.phase -= 1.0;
+
+            if (wavetables == nullptr && antialiasing == AntialiasingMode::MinBlep)
+                blep.addStep(2.0f, voice.phase / voice.phaseIncrement);
+        }
+    }
+
+    // === Bitcrusher ===
+    // Runs oversampled: the hold steps land on a finer grid and their images above the base Nyquist are filtered out
+    bool bitcrusherActive = crushDepth > 1.0f;
+    if (bitcrusherActive)
+    {
+        oversampler.setup(params.oversamplingFactor, params.oversamplingQuality);
+
+        int bitDepth = static_cast<int>(std::round(crushDepth));
+        bitDepth = std::clamp(bitDepth, 1, 16); // Prevent extreme values
+
+        int quantizationLevels = (1 << bitDepth) - 1;
+
+        int samplesPerHold = std::max(1, static_cast<int>(sampleRate * oversampler.getFactor() / crushRate));
+
+        const int numOversampled = numSamples * oversampler.getFactor();
+        float* oversampled = oversampler.upsample(voice.scratch, numSamples);
+
+        for (int sample = 0; sample < numOversampled; ++sample)
+        {
+            if (square.bitcrushCounter == 0)
+            {
+                // Quantize current sample
+                square.lastBitcrushedSample = std::round(oversampled[sample] * quantizationLevels) / quantizationLevels;
+            }
+
+            oversampled[sample] = square.lastBitcrushedSample;
+
+            square.bitcrushCounter = (square.bitcrushCounter + 1) % samplesPerHold;
+        }
+
+        oversampler.downsample(voice.scratch, numSamples);
+    }
+
+    for (int sample = 0; sample < numSamples; ++sample)
+    {
+        const int i = startSample + sample;
+        const float baseFreq = params.barkFilterFreq[i];
+        const float res = params.barkFilterResonance[i];
+
+        // === Bark Filter Envelope ===
+        if (square.barkEnvelope > 0.0f)
+        {
+            square.barkEnvelope -= square.barkDecayRate;
+            if (square.barkEnvelope < 0.0f)
+                square.barkEnvelope = 0.0f;
+        }
+
+        // Set dynamic bandpass cutoff and resonance
+        float modulatedCutoff = baseFreq + square.barkEnvelope * 2000.0f; // Sweep range
+
+        square.barkFilter.setParameters(modulatedCutoff, res);
+
+        // Apply to sample
+        voice.scratch[sample] = square.barkFilter.processSample(voice.scratch[sample]);
+    }
+}
+
+/**
+ * @brief Creates the "Chirp" sound using a Triangle Wave and Effects
+ * @param startSample position of the first sample inside the host block, used to index the parameter ramps
+ * @param numSamples number of samples to render into the scratch buffer
+ */
+void AnimalVoice::renderTriangle(int startSample, int numSamples)
+{
+    auto& voice = pool.common[static_cast<size_t>(index)];
+    auto& triangle = pool.triangle[static_cast<size_t>(index)];
+    const double sampleRate = getSampleRate();
+    const WavetableBank* wavetables = params.engine == OscillatorEngine::Wavetable ? pool.wavetables.get() : nullptr;
+
+    const double samplesPerMs = sampleRate / 1000.0;
+    const double maxDelaySamples = triangle.echo.getMaximumDelay();
+
+    // === Chirp LFO, one block at a time ===
+    float* chirp = voice.modulation;
+    Lfo::renderSine(chirp, triangle.chirpPhase, params.chirpRate, params.chirpDepth, startSample, numSamples, sampleRate);
+
+    for (int sample = 0; sample < numSamples; ++sample)
+    {
+        const int i = startSample + sample;
+        const float echoMix = params.echoMix[i];
+
+        float env = voice.adsr.getNextSample();
+        voice.level = env;
+
+        // === Glide Update ===
+        if (triangle.glideSamplesLeft > 0)
+        {
+            triangle.glideCurrentFreq += triangle.glideStep;
+            --triangle.glideSamplesLeft;
+        }
+        else
+        {
+            triangle.glideCurrentFreq = triangle.glideTargetFreq;
+        }
+
+        // === Triangle oscillator ===
+        voice.phaseIncrement = triangle.glideCurrentFreq / sampleRate;
+        // A triangle has no steps, only corners, so minBLEP mode uses the polynomial corner correction too
+        float rawSample = 0.0f;
+
+        if (wavetables != nullptr)
+            rawSample = wavetables->read(WavetableBank::triangle, wavetables->getOctave(voice.phaseIncrement), voice.phase);
+        else if (params.antialiasing == AntialiasingMode::Naive)
+            rawSample = static_cast<float>(4.0 * std::abs(voice.phase - 0.5) - 1.0);
+        else
+            rawSample = PolyBlep::triangle(voice.phase, voice.phaseIncrement);
+
+        // === Chirp (AM) ===
+        float am = 1.0f - chirp[sample];
+
+        float drySample = rawSample * env * am;
+
+        // === Echo with fade-out based on ADSR ===
+        double echoFade = juce::jlimit(0.0f, 1.0f, env); // 0 when envelope is silent, 1 at peak
+
+        const double delaySamples = juce::jlimit(1.0, maxDelaySamples, params.echoTimeMs[i] * samplesPerMs);
+
+        double delayedSample = triangle.echo.read<DelayInterpolation::Linear>(delaySamples) * echoFade;
+        double wetSample     = (1.0 - echoMix) * drySample + echoMix * delayedSample;
+
+        double feedback = delayedSample * 0.4 * env;
+
+        triangle.echo.push(drySample + feedback);
+        voice.scratch[sample] = static_cast<float>(wetSample);
+
+        voice.phase += voice.phaseIncrement;
+        if (voice.phase >= 1.0) voice.phase -= 1.0;
+    }
+}
@@ -0,0 +1,109 @@
+#pragma once
+#include <juce_audio_basics/juce_audio_basics.h>
+
+#include "LfoKernels.h"
+#include "ParameterSmoother.h"
+#include "VoicePool.h"
+
+
+/**
+ * @brief Plain copy of all parameters the voices need, filled once per block by the processor
+ *
+ * Voices only ever read from this, so the parameter tree is never touched per voice or per sample.
+ * Continuous parameters are ParameterRamps, index them with the sample position inside the host block.
+ */
+struct VoiceParameters
+{
+    int waveform = 0;
+    AntialiasingMode antialiasing = AntialiasingMode::PolyBlep;
+    OscillatorEngine engine = OscillatorEngine::Analytic;
+    juce::ADSR::Parameters adsr;
+
+    int oversamplingFactor = 2;     // For the saw waveshaper and the square bitcrusher
+    OversamplingQuality oversamplingQuality = OversamplingQuality::Realtime;
+
+    /// === Sine ===
+    ParameterRamp vibratoRate{ nullptr, 5.0f };
+    ParameterRamp vibratoDepth{ nullptr, 0.001f };
+    ParameterRamp tremoloRate{ nullptr, 4.0f };
+    ParameterRamp tremoloDepth{ nullptr, 0.5f };
+
+    /// === Saw ===
+    ParameterRamp combTimeMs{ nullptr, 10.0f };
+    ParameterRamp combFeedback{ nullptr, 0.25f };
+    ParameterRamp formantFreq{ nullptr, 800.0f };
+    ParameterRamp formantResonance{ nullptr, 1.0f };
+    ParameterRamp drive{ nullptr, 3.0f };
+    ParameterRamp shape{ nullptr, 0.5f };
+    WaveshaperCurve curve = WaveshaperCurve::Clip;
+
+    /// === Square ===
+    float bitcrushRate = 8000.0f;
+    float bitcrushDepth = 16.0f;
+    ParameterRamp barkFilterFreq{ nullptr, 800.0f };
+    ParameterRamp barkFilterResonance{ nullptr, 1.0f };
+
+    /// === Triangle ===
+    float glideTime = 0.05f;
+    float glideDepth = 12.0f;
+    ParameterRamp chirpRate{ nullptr, 20.0f };
+    ParameterRamp chirpDepth{ nullptr, 0.5f };
+    ParameterRamp echoTimeMs{ nullptr, 80.0f };
+    ParameterRamp echoMix{ nullptr, 0.3f };
+};
+
+
+/**
+ * @brief The only sound of the synth. Every voice can play every animal
+ */
+class AnimalSound : public juce::SynthesiserSound
+{
+public:
+    bool appliesToNote(int) override { return true; }
+    bool appliesToChannel(int) override { return true; }
+};
+
+
+/**
+ * @brief A single voice of the AnimalSynthesiser
+ *
+ * The voice itself is only a handle. All of its DSP state lives in its slot of the VoicePool.
+ * The animal is chosen when the note starts and kept until the voice has finished, so switching
+ * the waveform never cuts off notes that are still ringing.
+ *
+ * A voice renders the same way for float and double output. Its feedback loops and phases always
+ * run in double, only the mono scratch it is summed from is float.
+ */
+class AnimalVoice : public juce::SynthesiserVoice
+{
+public:
+    AnimalVoice(VoicePool& voicePool, int voiceIndex, const VoiceParameters& voiceParameters);
+
+    bool canPlaySound(juce::SynthesiserSound* sound) override;
+
+    void startNote(int midiNoteNumber, float velocity, juce::SynthesiserSound* sound, int currentPitchWheelPosition) override;
+    void stopNote(float velocity, bool allowTailOff) override;
+
+    void pitchWheelMoved(int) override {}
+    void controllerMoved(int, int) override {}
+
+    void renderNextBlock(juce::AudioBuffer<float>& outputBuffer, int startSample, int numSamples) override;
+    void renderNextBlock(juce::AudioBuffer<double>& outputBuffer, int startSample, int numSamples) override;
+
+    float getCurrentLevel() const noexcept;
+
+private:
+    template <typename SampleType>
+    void renderInto(juce::AudioBuffer<SampleType>& outputBuffer, int startSample, int numSamples);
+
+    void renderSine(int startSample, int numSamples);
+    void renderSaw(int startSample, int numSamples);
+    void renderSquare(int startSample, int numSamples);
+    void renderTriangle(int startSample, int numSamples);
+
+    VoicePool& pool;
+    const int index;
+    const VoiceParameters& params;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AnimalVoice)
+};
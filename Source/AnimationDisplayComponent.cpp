@@ -3,42 +3,56 @@
 #include <juce_graphics/juce_graphics.h>
 #include <juce_core/juce_core.h>
 
-#include <BinaryData.h>
-
-AnimationDisplayComponent::AnimationDisplayComponent()
-{
-    startTimerHz(60); // ~60 FPS for smooth animation
-}
-
 /**
  * @brief loads a series of images from the assets folder.
  *
+ * Returns immediately. Cached animals are shown right away, others replace the current frames as soon
+ * as they are decoded, unless another animal has been requested in the meantime.
+ *
  * @param animalName The Name of the Folder that contains the images. Both the folder and images need to have the same name!
  */
 void AnimationDisplayComponent::loadFrames(const juce::String& animalName)
 {
-    frames.clear();
-    int index = 0;
+    currentAnimal = animalName;
+    atlasSize = {};
+    requestAtlas();
+}
 
-    while (true)
-    {
-        juce::String resourceName = animalName + "_" + juce::String(index) + "_png";
+/**
+ * @brief Asks the loader for the current animal at the current pixel size of the component.
+ */
+void AnimationDisplayComponent::requestAtlas()
+{
+    const float scale = juce::Component::getApproximateScaleFactorForComponent(this);
+    const auto size = (getLocalBounds().toFloat() * scale).getSmallestIntegerContainer();
 
-        int dataSize = 0;
-        const void* data = BinaryData::getNamedResource(resourceName.toRawUTF8(), dataSize);
+    // Nothing to show yet, resized() asks again once the component has a size
+    if (currentAnimal.isEmpty() || size.isEmpty() || size == atlasSize)
+        return;
 
-        if (data == nullptr)
-            break;
+    atlasSize = size;
+    const int request = ++slot->latestRequest;
 
-        juce::Image img = juce::ImageCache::getFromMemory(data, dataSize);
+    if (auto cached = loader->findCached(currentAnimal, size.getWidth(), size.getHeight()))
+    {
+        std::atomic_store(&slot->atlas, std::move(cached));
+        repaint();
+        return;
+    }
 
-        if (img.isValid())
-            frames.push_back(img);
+    std::weak_ptr<FrameSlot> target = slot;
 
-        ++index;
-    }
+    loader->loadAsync(currentAnimal, size.getWidth(), size.getHeight(), [target, request](std::shared_ptr<const SpriteAtlas> loaded)
+    {
+        if (auto s = target.lock())
+            if (s->latestRequest.load() == request)
+                std::atomic_store(&s->atlas, std::move(loaded));
+    });
+}
 
-    repaint();
+void AnimationDisplayComponent::resized()
+{
+    requestAtlas();
 }
 
 
@@ -52,13 +66,14 @@ void AnimationDisplayComponent::loadFrames(const juce::String& animalName)
  */
 void AnimationDisplayComponent::paint(juce::Graphics& g)
 {
-    if (!frames.empty())
+    const auto atlas = std::atomic_load(&slot->atlas);
+
+    if (atlas != nullptr && atlas->numFrames > 0)
     {
-        int index = static_cast<int>(envelopeLevel.load() * static_cast<float>(frames.size() - 1));
-        index = juce::jlimit(0, static_cast<int>(frames.size() - 1), index);
-        auto& img = frames[(size_t)index];
+        const int index = getFrameIndex(*atlas);
 
-        g.drawImageWithin(img, 0, 0, getWidth(), getHeight(), juce::RectanglePlacement::centred);
+        // Already at display size, so this is a plain blit of one tile of the atlas
+        g.drawImageWithin(atlas->image.getClippedImage(atlas->getFrame(index)), 0, 0, getWidth(), getHeight(), juce::RectanglePlacement::centred);
     }
     else
     {
@@ -85,9 +100,15 @@ void AnimationDisplayComponent::setEnvelopeLevel(float level)
     envelopeLevel.store(level);
 }
 
+/**
+ * @brief Shows frames that did not come from the assets. They are packed on the calling thread and not cached.
+ */
 void AnimationDisplayComponent::setFrames(std::vector<juce::Image> newFrames)
 {
-    frames = std::move(newFrames);
+    currentAnimal = {};
+    ++slot->latestRequest;  // Drops any animal still being decoded
+
+    std::atomic_store(&slot->atlas, SpriteAtlas::pack({}, newFrames, juce::jmax(1, getWidth()), juce::jmax(1, getHeight())));
     repaint();
 }
 
@@ -113,6 +134,18 @@ void AnimationDisplayComponent::setNewAnimal(int waveformIndex)
     }
 }
 
+/**
+ * @brief Lets the component follow the processor's envelope and waveform on its own.
+ *
+ * The source is polled in refresh() on the message thread, so the audio thread never has to know about this component.
+ *
+ * @param source The processor's feedback channel, or nullptr to stop following it
+ */
+void AnimationDisplayComponent::setFeedbackSource(const VisualFeedback* source)
+{
+    feedback = source;
+}
+
 /**
  *
  * @return Returns the current Animal that is being displayed.
@@ -122,7 +155,37 @@ int AnimationDisplayComponent::getIndex()
     return curIndex;
 }
 
-void AnimationDisplayComponent::timerCallback()
+/**
+ * @brief Called by the RepaintScheduler once per frame. Only repaints if a different frame or animal is due.
+ */
+void AnimationDisplayComponent::refresh()
 {
-    repaint();
+    if (feedback != nullptr)
+    {
+        const int waveformIndex = feedback->waveformIndex.load(std::memory_order_relaxed);
+
+        if (waveformIndex != curIndex)
+            setNewAnimal(waveformIndex);
+
+        envelopeLevel.store(feedback->envelopeLevel.load(std::memory_order_relaxed));
+    }
+
+    const auto atlas = std::atomic_load(&slot->atlas);
+    const int frame = atlas != nullptr && atlas->numFrames > 0 ? getFrameIndex(*atlas) : -1;
+
+    if (atlas != shownAtlas || frame != shownFrame)
+    {
+        shownAtlas = atlas;
+        shownFrame = frame;
+        repaint();
+    }
+}
+
+/**
+ * @return The frame that matches the current envelope level
+ */
+int AnimationDisplayComponent::getFrameIndex(const SpriteAtlas& atlas) const
+{
+    const int index = static_cast<int>(envelopeLevel.load() * static_cast<float>(atlas.numFrames - 1));
+    return juce::jlimit(0, atlas.numFrames - 1, index);
 }
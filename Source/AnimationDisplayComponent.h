@@ -3,6 +3,13 @@
 #include <juce_graphics/juce_graphics.h>
 #include <juce_core/juce_core.h>
 
+#include "AnimationLoader.h"
+#include "RepaintScheduler.h"
+#include "VisualFeedback.h"
+
+#include <atomic>
+#include <memory>
+
 /**
  * @brief A simple Component that draws Frames from loaded image based on the ADSR envelope
  *
@@ -10,27 +17,52 @@
  * You call loadFrames you give it the name of the folder as the parameter.
  *
  * @attention the images should be named like this: <foldername>_<framenumber>
+ *
+ * Frames come from the shared AnimationLoader as a sprite atlas scaled to the size of this component.
+ * Animals that are already cached switch instantly. Otherwise the previous animal stays on screen
+ * until the new one has been decoded in the background, so switching never blocks the message thread.
  */
-class AnimationDisplayComponent : public juce::Component, private juce::Timer
+class AnimationDisplayComponent : public juce::Component, public RepaintScheduler::Client
 {
 public:
-    AnimationDisplayComponent();
+    AnimationDisplayComponent() = default;
 
     void loadFrames(const juce::String& animalName);
     void paint(juce::Graphics& g) override;
+    void resized() override;
     void setText(juce::String t);
     void setEnvelopeLevel(float level);
     void setFrames(std::vector<juce::Image> newFrames);
 
     void setNewAnimal(int waveformIndex);
+    void setFeedbackSource(const VisualFeedback* source);
 
     int getIndex();
 
+    void refresh() override;
+
 private:
-    void timerCallback() override;
+    void requestAtlas();
+    int getFrameIndex(const SpriteAtlas& atlas) const;
+
+    /**
+     * @brief Shared with the decoder jobs, which only publish into it while the component is alive
+     */
+    struct FrameSlot
+    {
+        std::shared_ptr<const SpriteAtlas> atlas;   // Only accessed through std::atomic_load/store
+        std::atomic<int> latestRequest{ 0 };
+    };
+
+    int curIndex = -1;
+    juce::String currentAnimal;
+    juce::Rectangle<int> atlasSize;                 // Pixel size of the last request
 
-    int curIndex;
-    std::vector<juce::Image> frames;
+    std::shared_ptr<const SpriteAtlas> shownAtlas;  // What the last refresh saw
+    int shownFrame = -1;
+    const VisualFeedback* feedback = nullptr;
+    juce::SharedResourcePointer<AnimationLoader> loader;
+    std::shared_ptr<FrameSlot> slot = std::make_shared<FrameSlot>();
     std::atomic<float> envelopeLevel{ 0.0f };
     juce::String txt = "Text.";
 };
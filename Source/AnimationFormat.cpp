@@ -0,0 +1,146 @@
+#include "AnimationFormat.h"
+
+
+static constexpr char animationMagic[4] = { 'A', 'N', 'I', 'M' };
+
+bool AnimationFormat::write(juce::OutputStream& output, const std::vector<juce::Image>& frames)
+{
+    if (frames.empty())
+        return false;
+
+    const int width = frames.front().getWidth();
+    const int height = frames.front().getHeight();
+    const size_t numBytes = static_cast<size_t>(width) * static_cast<size_t>(height) * 4;
+
+    for (const auto& frame : frames)
+        if (frame.getWidth() != width || frame.getHeight() != height)
+            return false;
+
+    output.write(animationMagic, sizeof(animationMagic));
+    output.writeInt(version);
+    output.writeInt(width);
+    output.writeInt(height);
+    output.writeInt(static_cast<int>(frames.size()));
+
+    std::vector<juce::uint8> previous(numBytes, 0), current(numBytes), delta(numBytes);
+
+    for (const auto& frame : frames)
+    {
+        const juce::Image argb = frame.convertedToFormat(juce::Image::ARGB);
+        const juce::Image::BitmapData bitmap(argb, juce::Image::BitmapData::readOnly);
+
+        for (int y = 0; y < height; ++y)
+        {
+            for (int x = 0; x < width; ++x)
+            {
+                const auto* pixel = reinterpret_cast<const juce::PixelARGB*>(bitmap.getPixelPointer(x, y));
+                auto* bytes = current.data() + (static_cast<size_t>(y) * static_cast<size_t>(width) + static_cast<size_t>(x)) * 4;
+
+                bytes[0] = pixel->getAlpha();
+                bytes[1] = pixel->getRed();
+                bytes[2] = pixel->getGreen();
+                bytes[3] = pixel->getBlue();
+            }
+        }
+
+        for (size_t i = 0; i < numBytes; ++i)
+            delta[i] = static_cast<juce::uint8>(current[i] - previous[i]);
+
+        juce::MemoryOutputStream packed;
+        {
+            juce::GZIPCompressorOutputStream zlib(packed, 9);
+            zlib.write(delta.data(), numBytes);
+        }
+
+        output.writeInt(static_cast<int>(packed.getDataSize()));
+        output.write(packed.getData(), packed.getDataSize());
+
+        std::swap(previous, current);
+    }
+
+    return true;
+}
+
+
+AnimationDecoder::AnimationDecoder(const void* data, size_t dataSize)
+    : input(data, dataSize, false)
+{
+    char magic[4] = {};
+
+    if (input.read(magic, sizeof(magic)) != static_cast<int>(sizeof(magic))
+        || std::memcmp(magic, animationMagic, sizeof(magic)) != 0
+        || input.readInt() != AnimationFormat::version)
+        return;
+
+    const int w = input.readInt();
+    const int h = input.readInt();
+    const int n = input.readInt();
+
+    if (w <= 0 || h <= 0 || n <= 0)
+        return;
+
+    width = w;
+    height = h;
+    numFrames = n;
+    pixels.calloc(static_cast<size_t>(width) * static_cast<size_t>(height) * 4);
+}
+
+bool AnimationDecoder::readNextFrame(juce::Image& frame)
+{
+    if (framesRead >= numFrames)
+        return false;
+
+    const int compressedSize = input.readInt();
+
+    if (compressedSize <= 0 || compressedSize > input.getNumBytesRemaining())
+    {
+        numFrames = framesRead;
+        return false;
+    }
+
+    compressed.setSize(static_cast<size_t>(compressedSize), false);
+    input.read(compressed.getData(), compressedSize);
+
+    // Undo the delta against the previous frame while inflating
+    const size_t numBytes = static_cast<size_t>(width) * static_cast<size_t>(height) * 4;
+    juce::GZIPDecompressorInputStream zlib(new juce::MemoryInputStream(compressed, false), true,
+                                           juce::GZIPDecompressorInputStream::zlibFormat, static_cast<juce::int64>(numBytes));
+    juce::uint8 chunk[4096];
+    size_t position = 0;
+
+    while (position < numBytes)
+    {
+        const int bytesRead = zlib.read(chunk, static_cast<int>(juce::jmin(sizeof(chunk), numBytes - position)));
+
+        if (bytesRead <= 0)
+            break;
+
+        for (int i = 0; i < bytesRead; ++i)
+            pixels[position + static_cast<size_t>(i)] = static_cast<juce::uint8>(pixels[position + static_cast<size_t>(i)] + chunk[i]);
+
+        position += static_cast<size_t>(bytesRead);
+    }
+
+    if (position != numBytes)
+    {
+        numFrames = framesRead;
+        return false;
+    }
+
+    if (!frame.isValid() || frame.getWidth() != width || frame.getHeight() != height || frame.getFormat() != juce::Image::ARGB)
+        frame = juce::Image(juce::Image::ARGB, width, height, false, juce::SoftwareImageType());
+
+    juce::Image::BitmapData bitmap(frame, juce::Image::BitmapData::writeOnly);
+
+    for (int y = 0; y < height; ++y)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            const auto* bytes = pixels.get() + (static_cast<size_t>(y) * static_cast<size_t>(width) + static_cast<size_t>(x)) * 4;
+            reinterpret_cast<juce::PixelARGB*>(bitmap.getPixelPointer(x, y))->setARGB(bytes[0], bytes[1], bytes[2], bytes[3]);
+        }
+    }
+
+    ++framesRead;
+    return true;
+}
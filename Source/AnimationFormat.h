@@ -0,0 +1,62 @@
+#pragma once
+#include <juce_graphics/juce_graphics.h>
+#include <juce_core/juce_core.h>
+
+#include <vector>
+
+
+/// === .anim files ===
+// Written at build time by Tools/AssetPacker, read by the AnimationLoader.
+//
+//   "ANIM" | int32 version | int32 width | int32 height | int32 numFrames
+//   numFrames x ( int32 compressedSize | zlib( width * height * 4 delta bytes ) )
+//
+// Pixels are premultiplied A, R, G, B bytes. Every byte is stored as the difference to the same byte of
+// the previous frame (the first frame is compared against transparent black), so the parts of the image
+// that don't move compress to almost nothing.
+namespace AnimationFormat
+{
+    constexpr int version = 1;
+
+    /**
+     * @brief Encodes frames that all have the same size.
+     *
+     * @return false if there are no frames or their sizes differ
+     */
+    bool write(juce::OutputStream& output, const std::vector<juce::Image>& frames);
+}
+
+
+/**
+ * @brief Streaming decoder for .anim data, one frame at a time
+ *
+ * Only keeps the previous frame and one compressed frame in memory, so a whole animation never has
+ * to exist as separate full-size images.
+ */
+class AnimationDecoder
+{
+public:
+    AnimationDecoder(const void* data, size_t dataSize);
+
+    bool isValid() const noexcept { return numFrames > 0; }
+    int getWidth() const noexcept { return width; }
+    int getHeight() const noexcept { return height; }
+    int getNumFrames() const noexcept { return numFrames; }
+
+    /**
+     * @brief Decodes the next frame into an ARGB image.
+     *
+     * @return false once all frames have been read or the data is corrupt
+     */
+    bool readNextFrame(juce::Image& frame);
+
+private:
+    juce::MemoryInputStream input;
+    int width = 0, height = 0, numFrames = 0;
+    int framesRead = 0;
+
+    juce::HeapBlock<juce::uint8> pixels;
+    juce::MemoryBlock compressed;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AnimationDecoder)
+};
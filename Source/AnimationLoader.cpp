@@ -0,0 +1,172 @@
+#include "AnimationLoader.h"
+#include "AnimationFormat.h"
+
+#include <BinaryData.h>
+
+
+std::shared_ptr<const SpriteAtlas> SpriteAtlas::pack(const juce::String& animal, const std::vector<juce::Image>& frames, int width, int height)
+{
+    // All frames of an animation share one size, so the first one decides the layout
+    const auto sourceSize = frames.empty() ? juce::Rectangle<int>() : frames.front().getBounds();
+    auto atlas = create(animal, sourceSize, static_cast<int>(frames.size()), width, height);
+
+    for (int i = 0; i < atlas->numFrames; ++i)
+        atlas->drawFrame(i, frames[static_cast<size_t>(i)]);
+
+    return atlas;
+}
+
+std::shared_ptr<SpriteAtlas> SpriteAtlas::create(const juce::String& animal, juce::Rectangle<int> sourceSize, int numFrames, int width, int height)
+{
+    constexpr int maxAtlasWidth = 4096;
+
+    auto atlas = std::make_shared<SpriteAtlas>();
+    atlas->animal = animal;
+
+    if (numFrames <= 0 || sourceSize.isEmpty() || width <= 0 || height <= 0)
+        return atlas;
+
+    const auto fitted = juce::RectanglePlacement(juce::RectanglePlacement::centred)
+                            .appliedTo(sourceSize, juce::Rectangle<int>(width, height));
+
+    atlas->frameWidth = juce::jmax(1, fitted.getWidth());
+    atlas->frameHeight = juce::jmax(1, fitted.getHeight());
+    atlas->numFrames = numFrames;
+    atlas->columns = juce::jlimit(1, numFrames, maxAtlasWidth / atlas->frameWidth);
+
+    const int rows = (numFrames + atlas->columns - 1) / atlas->columns;
+    atlas->image = juce::Image(juce::Image::ARGB, atlas->columns * atlas->frameWidth, rows * atlas->frameHeight, true, juce::SoftwareImageType());
+
+    return atlas;
+}
+
+void SpriteAtlas::drawFrame(int index, const juce::Image& frame)
+{
+    const auto target = getFrame(index);
+
+    juce::Graphics g(image);
+    g.setImageResamplingQuality(juce::Graphics::highResamplingQuality);
+    g.drawImage(frame, target.getX(), target.getY(), target.getWidth(), target.getHeight(),
+                0, 0, frame.getWidth(), frame.getHeight());
+}
+
+
+AnimationLoader::AnimationLoader() = default;
+
+AnimationLoader::~AnimationLoader()
+{
+    decoderThread.removeAllJobs(true, 5000);
+}
+
+std::shared_ptr<const SpriteAtlas> AnimationLoader::findCached(const juce::String& animalName, int width, int height)
+{
+    const auto key = makeKey(animalName, width, height);
+    const juce::ScopedLock lock(cacheLock);
+
+    for (auto& entry : entries)
+    {
+        if (entry.key == key)
+        {
+            entry.lastUsed = ++useCounter;
+            return entry.atlas;
+        }
+    }
+
+    return nullptr;
+}
+
+void AnimationLoader::loadAsync(const juce::String& animalName, int width, int height, Callback onLoaded)
+{
+    decoderThread.addJob([this, animalName, width, height, onLoaded = std::move(onLoaded)]
+    {
+        onLoaded(getOrBuild(animalName, width, height));
+    });
+}
+
+void AnimationLoader::setBudget(size_t bytes)
+{
+    const juce::ScopedLock lock(cacheLock);
+    budgetBytes = bytes;
+    evictUnusedEntries();
+}
+
+/**
+ * @brief Decodes an animation frame by frame straight into its atlas.
+ *
+ * @param animalName The name of the asset folder the animation was packed from
+ * @param width Width the frames are scaled to fit into
+ * @param height Height the frames are scaled to fit into
+ * @return The atlas, empty if there is no such animation
+ */
+std::shared_ptr<const SpriteAtlas> AnimationLoader::decode(const juce::String& animalName, int width, int height)
+{
+    const juce::String resourceName = animalName + "_anim";
+
+    int dataSize = 0;
+    const void* data = BinaryData::getNamedResource(resourceName.toRawUTF8(), dataSize);
+
+    if (data == nullptr)
+        return SpriteAtlas::create(animalName, {}, 0, width, height);
+
+    AnimationDecoder decoder(data, static_cast<size_t>(dataSize));
+    auto atlas = SpriteAtlas::create(animalName, { decoder.getWidth(), decoder.getHeight() }, decoder.getNumFrames(), width, height);
+
+    juce::Image frame;
+
+    for (int i = 0; i < atlas->numFrames && decoder.readNextFrame(frame); ++i)
+        atlas->drawFrame(i, frame);
+
+    return atlas;
+}
+
+/**
+ * @brief Runs on the decoder thread. The lock is only held for the lookups, never while decoding.
+ */
+std::shared_ptr<const SpriteAtlas> AnimationLoader::getOrBuild(const juce::String& animalName, int width, int height)
+{
+    if (auto cached = findCached(animalName, width, height))
+        return cached;
+
+    auto atlas = decode(animalName, width, height);
+
+    const juce::ScopedLock lock(cacheLock);
+    entries.push_back({ makeKey(animalName, width, height), atlas, ++useCounter });
+    evictUnusedEntries();
+
+    return atlas;
+}
+
+/**
+ * @brief Drops least recently used atlases until the budget is met. Atlases that are still shown are kept.
+ */
+void AnimationLoader::evictUnusedEntries()
+{
+    auto totalBytes = [this]
+    {
+        size_t total = 0;
+
+        for (const auto& entry : entries)
+            total += entry.atlas->getSizeInBytes();
+
+        return total;
+    };
+
+    while (totalBytes() > budgetBytes)
+    {
+        auto victim = entries.end();
+
+        for (auto it = entries.begin(); it != entries.end(); ++it)
+            if (it->atlas.use_count() == 1 && (victim == entries.end() || it->lastUsed < victim->lastUsed))
+                victim = it;
+
+        if (victim == entries.end())
+            break;
+
+        entries.erase(victim);
+    }
+}
+
+juce::String AnimationLoader::makeKey(const juce::String& animalName, int width, int height)
+{
+    return animalName + "@" + juce::String(width) + "x" + juce::String(height);
+}
@@ -0,0 +1,108 @@
+#pragma once
+#include <juce_graphics/juce_graphics.h>
+#include <juce_core/juce_core.h>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+
+/**
+ * @brief All frames of one animation, scaled to the display size and packed into a single image
+ *
+ * Never modified once it has been published.
+ */
+struct SpriteAtlas
+{
+    juce::String animal;
+    juce::Image image;
+    int frameWidth = 0;
+    int frameHeight = 0;
+    int numFrames = 0;
+    int columns = 1;
+
+    juce::Rectangle<int> getFrame(int index) const noexcept
+    {
+        return { (index % columns) * frameWidth, (index / columns) * frameHeight, frameWidth, frameHeight };
+    }
+
+    size_t getSizeInBytes() const noexcept
+    {
+        return static_cast<size_t>(image.getWidth()) * static_cast<size_t>(image.getHeight()) * 4;
+    }
+
+    /**
+     * @brief Scales every frame to fit within width x height (keeping its aspect ratio) and packs them row by row.
+     */
+    static std::shared_ptr<const SpriteAtlas> pack(const juce::String& animal, const std::vector<juce::Image>& frames, int width, int height);
+
+    /**
+     * @brief Creates an empty atlas for numFrames frames of sourceSize, scaled to fit within width x height.
+     *
+     * Fill it with drawFrame() before publishing it.
+     */
+    static std::shared_ptr<SpriteAtlas> create(const juce::String& animal, juce::Rectangle<int> sourceSize, int numFrames, int width, int height);
+
+    void drawFrame(int index, const juce::Image& frame);
+};
+
+
+/**
+ * @brief Process-wide cache of animal animations, decoded on a background thread
+ *
+ * Shared by every AnimationDisplayComponent in the process through a juce::SharedResourcePointer,
+ * so all editors of all plugin instances decode each animal only once per display size, on the same
+ * single decoder thread. Neither the audio thread nor the message thread ever decodes an image.
+ *
+ * Memory is bounded by a budget. When it is exceeded, the least recently used atlases that no
+ * display is currently showing are dropped.
+ */
+class AnimationLoader
+{
+public:
+    using Callback = std::function<void(std::shared_ptr<const SpriteAtlas>)>;
+
+    static constexpr size_t defaultBudgetBytes = 48 * 1024 * 1024;
+
+    AnimationLoader();
+    ~AnimationLoader();
+
+    /**
+     * @return The atlas if it has already been built for this size, nullptr otherwise. Never decodes
+     */
+    std::shared_ptr<const SpriteAtlas> findCached(const juce::String& animalName, int width, int height);
+
+    /**
+     * @brief Queues the animation for decoding and packing. onLoaded is called on the decoder thread.
+     */
+    void loadAsync(const juce::String& animalName, int width, int height, Callback onLoaded);
+
+    void setBudget(size_t bytes);
+
+    /**
+     * @brief Streams the packed animation "<animal>.anim" from BinaryData into an atlas on the calling thread.
+     */
+    static std::shared_ptr<const SpriteAtlas> decode(const juce::String& animalName, int width, int height);
+
+private:
+    struct Entry
+    {
+        juce::String key;
+        std::shared_ptr<const SpriteAtlas> atlas;
+        juce::uint64 lastUsed = 0;
+    };
+
+    std::shared_ptr<const SpriteAtlas> getOrBuild(const juce::String& animalName, int width, int height);
+    void evictUnusedEntries();
+
+    static juce::String makeKey(const juce::String& animalName, int width, int height);
+
+    juce::CriticalSection cacheLock;
+    std::vector<Entry> entries;
+    juce::uint64 useCounter = 0;
+    size_t budgetBytes = defaultBudgetBytes;
+
+    juce::ThreadPool decoderThread{ 1 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AnimationLoader)
+};
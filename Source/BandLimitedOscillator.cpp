@@ -0,0 +1,92 @@
+#include "BandLimitedOscillator.h"
+#include <juce_dsp/juce_dsp.h>
+
+#include <complex>
+
+
+/**
+ * @brief The table is shared by every voice of every plugin instance in the process.
+ *
+ * Built on first use. The voices touch it for the first time in prepareToPlay, never on the audio thread.
+ */
+const MinBlepTable& MinBlepTable::getInstance()
+{
+    static const MinBlepTable instance;
+    return instance;
+}
+
+MinBlepTable::MinBlepTable()
+{
+    constexpr int length = lengthInSamples * oversampling;
+    constexpr int fftOrder = 14;                  // Plenty of zero padding for the cepstrum
+    constexpr int fftSize = 1 << fftOrder;
+    static_assert(fftSize >= 4 * length, "FFT too small for the minBLEP length");
+
+    juce::dsp::FFT fft(fftOrder);
+    std::vector<std::complex<float>> a(static_cast<size_t>(fftSize)), b(static_cast<size_t>(fftSize));
+
+    // === 1. Blackman-windowed sinc ===
+    for (int i = 0; i < length; ++i)
+    {
+        const double x = static_cast<double>(i - length / 2) / oversampling;
+        const double sinc = x == 0.0 ? 1.0 : std::sin(juce::MathConstants<double>::pi * x) / (juce::MathConstants<double>::pi * x);
+        const double w = static_cast<double>(i) / (length - 1);
+        const double window = 0.42 - 0.5 * std::cos(juce::MathConstants<double>::twoPi * w)
+                                   + 0.08 * std::cos(2.0 * juce::MathConstants<double>::twoPi * w);
+
+        a[static_cast<size_t>(i)] = static_cast<float>(sinc * window);
+    }
+
+    // === 2. Real cepstrum ===
+    fft.perform(a.data(), b.data(), false);
+
+    for (auto& bin : b)
+        bin = std::log(std::max(std::abs(bin), 1.0e-9f));
+
+    fft.perform(b.data(), a.data(), true);
+
+    // Fold the cepstrum onto positive quefrencies, which makes the result minimum-phase
+    for (int i = 1; i < fftSize / 2; ++i)
+        a[static_cast<size_t>(i)] *= 2.0f;
+
+    for (int i = fftSize / 2 + 1; i < fftSize; ++i)
+        a[static_cast<size_t>(i)] = 0.0f;
+
+    fft.perform(a.data(), b.data(), false);
+
+    for (auto& bin : b)
+        bin = std::exp(bin);
+
+    fft.perform(b.data(), a.data(), true);
+
+    // === 3. Integrate the minimum-phase impulse into a step ===
+    table.resize(static_cast<size_t>(length));
+    double sum = 0.0;
+
+    for (int i = 0; i < length; ++i)
+    {
+        sum += a[static_cast<size_t>(i)].real();
+        table[static_cast<size_t>(i)] = static_cast<float>(sum);
+    }
+
+    // Normalise so the step ends exactly at 1 and store only the residual
+    const float finalValue = table.back();
+
+    for (auto& value : table)
+        value = value / finalValue - 1.0f;
+}
+
+float MinBlepTable::residual(double samplesSinceStep) const noexcept
+{
+    const double position = samplesSinceStep * oversampling;
+    const int index = static_cast<int>(position);
+
+    if (index < 0)
+        return -1.0f;
+
+    if (index >= static_cast<int>(table.size()) - 1)
+        return 0.0f;
+
+    const float frac = static_cast<float>(position - index);
+    return table[static_cast<size_t>(index)] + frac * (table[static_cast<size_t>(index + 1)] - table[static_cast<size_t>(index)]);
+}
@@ -0,0 +1,165 @@
+#pragma once
+#include <juce_core/juce_core.h>
+
+#include <array>
+#include <vector>
+
+
+/**
+ * @brief How the saw, square and triangle oscillators deal with aliasing
+ */
+enum class AntialiasingMode
+{
+    Naive,      // The old, trivially computed waveforms
+    PolyBlep,   // Polynomial correction around every discontinuity, cheap and good enough for most notes
+    MinBlep     // Tabulated minimum-phase step, cleaner at the top of the keyboard
+};
+
+
+/// === PolyBLEP ===
+// Residuals scaled for a step of height 2 (from -1 to +1) and a slope change of 2 per sample,
+// which is what the usual naive waveforms produce.
+namespace PolyBlep
+{
+    /**
+     * @brief Correction for a hard step at phase 0
+     *
+     * @param t Phase of the oscillator (0..1)
+     * @param dt Phase increment per sample
+     */
+    inline double blep(double t, double dt) noexcept
+    {
+        if (t < dt)
+        {
+            t /= dt;
+            return t + t - t * t - 1.0;
+        }
+
+        if (t > 1.0 - dt)
+        {
+            t = (t - 1.0) / dt;
+            return t * t + t + t + 1.0;
+        }
+
+        return 0.0;
+    }
+
+    /**
+     * @brief Correction for a corner (change of slope) at phase 0
+     *
+     * @param t Phase of the oscillator (0..1)
+     * @param dt Phase increment per sample
+     */
+    inline double blamp(double t, double dt) noexcept
+    {
+        if (t < dt)
+        {
+            t = t / dt - 1.0;
+            return -1.0 / 3.0 * t * t * t;
+        }
+
+        if (t > 1.0 - dt)
+        {
+            t = (t - 1.0) / dt + 1.0;
+            return 1.0 / 3.0 * t * t * t;
+        }
+
+        return 0.0;
+    }
+
+    inline double wrap(double t) noexcept
+    {
+        return t >= 1.0 ? t - 1.0 : t;
+    }
+
+    inline float saw(double phase, double dt) noexcept
+    {
+        return static_cast<float>(2.0 * phase - 1.0 - blep(phase, dt));
+    }
+
+    inline float square(double phase, double dt) noexcept
+    {
+        const double naive = phase < 0.5 ? 1.0 : -1.0;
+        return static_cast<float>(naive + blep(phase, dt) - blep(wrap(phase + 0.5), dt));
+    }
+
+    inline float triangle(double phase, double dt) noexcept
+    {
+        // Peak at phase 0, trough at phase 0.5. The slope changes by 8 * dt per sample at both corners
+        const double naive = 4.0 * std::abs(phase - 0.5) - 1.0;
+        return static_cast<float>(naive - 4.0 * dt * blamp(phase, dt) + 4.0 * dt * blamp(wrap(phase + 0.5), dt));
+    }
+}
+
+
+/**
+ * @brief Minimum-phase band-limited step (minBLEP), built once per process
+ *
+ * Generated from a Blackman-windowed sinc whose minimum-phase version is found through the real
+ * cepstrum and then integrated. Being minimum-phase, the correction only affects samples after
+ * the discontinuity, so the oscillators need no extra latency.
+ */
+class MinBlepTable
+{
+public:
+    static constexpr int zeroCrossings = 16;
+    static constexpr int oversampling = 64;
+    static constexpr int lengthInSamples = zeroCrossings * 2;
+
+    static const MinBlepTable& getInstance();
+
+    /**
+     * @return The band-limited step minus the ideal step, at the given time after the discontinuity
+     */
+    float residual(double samplesSinceStep) const noexcept;
+
+private:
+    MinBlepTable();
+
+    std::vector<float> table;
+};
+
+
+/**
+ * @brief Per-voice accumulator for minBLEP corrections still to be added to the output
+ */
+struct MinBlepBuffer
+{
+    static constexpr int size = 64;
+    static_assert(size > MinBlepTable::lengthInSamples && juce::isPowerOfTwo(size), "size must be a power of two covering the table");
+
+    std::array<float, size> buffer{};
+    int position = 0;
+
+    /**
+     * @brief Registers a discontinuity that happened between the current and the next sample.
+     *
+     * @param height New value minus old value of the naive waveform
+     * @param samplesSinceStep How long before the next sample the step happened (0..1)
+     */
+    void addStep(float height, double samplesSinceStep) noexcept
+    {
+        const auto& table = MinBlepTable::getInstance();
+
+        for (int k = 0; k < MinBlepTable::lengthInSamples; ++k)
+            buffer[static_cast<size_t>((position + k) & (size - 1))] += height * table.residual(k + samplesSinceStep);
+    }
+
+    /**
+     * @return The correction for the current sample. Advances to the next one
+     */
+    float next() noexcept
+    {
+        auto& slot = buffer[static_cast<size_t>(position)];
+        const float value = slot;
+        slot = 0.0f;
+        position = (position + 1) & (size - 1);
+        return value;
+    }
+
+    void reset() noexcept
+    {
+        buffer.fill(0.0f);
+        position = 0;
+    }
+};
@@ -0,0 +1,115 @@
+#pragma once
+#include <juce_audio_basics/juce_audio_basics.h>
+
+#include "ParameterTable.h"
+
+#include <array>
+
+
+/**
+ * @brief Splits a host block into sub-blocks at the exact sample position of every event
+ *
+ * MIDI messages and parameter events are merged in time order. Everything between two events
+ * is rendered in one go, so the render loops stay tight and vectorisable, while a note-on at
+ * sample 700 of a 1024 sample block really starts at sample 700.
+ */
+class BlockScheduler
+{
+public:
+    /**
+     * @brief A sample-accurate parameter change for the current block
+     */
+    struct ParameterEvent
+    {
+        int samplePosition = 0;
+        ParamId param = ParamId::waveform;
+        float value = 0.0f;
+    };
+
+    static constexpr int maxParameterEvents = 128;
+
+    /**
+     * @brief Queues a parameter change for the next call to process(). Audio thread only, never allocates.
+     *
+     * @return false if the queue is full and the event was dropped
+     */
+    bool addParameterEvent(int samplePosition, ParamId param, float value) noexcept
+    {
+        if (numParameterEvents >= maxParameterEvents)
+            return false;
+
+        // Keep the queue sorted by position. It is tiny, so insertion sort is the fastest option
+        int insertAt = numParameterEvents;
+
+        while (insertAt > 0 && parameterEvents[static_cast<size_t>(insertAt - 1)].samplePosition > samplePosition)
+        {
+            parameterEvents[static_cast<size_t>(insertAt)] = parameterEvents[static_cast<size_t>(insertAt - 1)];
+            --insertAt;
+        }
+
+        parameterEvents[static_cast<size_t>(insertAt)] = { samplePosition, param, value };
+        ++numParameterEvents;
+        return true;
+    }
+
+    /**
+     * @brief Runs one host block.
+     *
+     * @param midi The block's MIDI messages
+     * @param numSamples Length of the block
+     * @param renderRange Called as renderRange(startSample, numSamples) for every stretch without events
+     * @param handleMidi Called with every MidiMessage at its position
+     * @param handleParameter Called with every ParameterEvent at its position
+     */
+    template <typename RenderFn, typename MidiFn, typename ParameterFn>
+    void process(const juce::MidiBuffer& midi, int numSamples,
+                 RenderFn&& renderRange, MidiFn&& handleMidi, ParameterFn&& handleParameter)
+    {
+        auto midiIterator = midi.cbegin();
+        const auto midiEnd = midi.cend();
+        int parameterIndex = 0;
+        int position = 0;
+
+        while (position < numSamples)
+        {
+            // === Apply everything that happens at this exact sample ===
+            while (midiIterator != midiEnd && (*midiIterator).samplePosition <= position)
+            {
+                handleMidi((*midiIterator).getMessage());
+                ++midiIterator;
+            }
+
+            while (parameterIndex < numParameterEvents
+                   && parameterEvents[static_cast<size_t>(parameterIndex)].samplePosition <= position)
+            {
+                handleParameter(parameterEvents[static_cast<size_t>(parameterIndex)]);
+                ++parameterIndex;
+            }
+
+            // === Render up to the next event ===
+            int nextEvent = numSamples;
+
+            if (midiIterator != midiEnd)
+                nextEvent = juce::jmin(nextEvent, (*midiIterator).samplePosition);
+
+            if (parameterIndex < numParameterEvents)
+                nextEvent = juce::jmin(nextEvent, parameterEvents[static_cast<size_t>(parameterIndex)].samplePosition);
+
+            renderRange(position, nextEvent - position);
+            position = nextEvent;
+        }
+
+        // Events at or behind the end of the block still have to be applied, e.g. a note-off
+        for (; midiIterator != midiEnd; ++midiIterator)
+            handleMidi((*midiIterator).getMessage());
+
+        for (; parameterIndex < numParameterEvents; ++parameterIndex)
+            handleParameter(parameterEvents[static_cast<size_t>(parameterIndex)]);
+
+        numParameterEvents = 0;
+    }
+
+private:
+    std::array<ParameterEvent, maxParameterEvents> parameterEvents{};
+    int numParameterEvents = 0;
+};
@@ -0,0 +1,120 @@
+#pragma once
+#include <juce_audio_basics/juce_audio_basics.h>
+
+#include "DelayLine.h"
+
+#include <cmath>
+#include <vector>
+
+
+/**
+ * @brief The Howl's chorus: one sine-modulated delay per channel, mixed with the dry signal
+ *
+ * Built on DelayLine: every block is written once, then read back with one modulated delay time per
+ * sample. The delay times are computed once per block and shared by all channels. Everything is
+ * allocated in prepare(). Depth changes are ramped over the block so turning the knob does not click.
+ */
+template <typename SampleType>
+class Chorus
+{
+public:
+    static constexpr double maxDelayMs = 50.0;
+    static constexpr SampleType sweep = SampleType(0.9);    // Depth 1 sweeps between 10 % and 190 % of the centre delay
+
+    void prepare(double newSampleRate, int maximumBlockSize, int numChannels)
+    {
+        sampleRate = newSampleRate;
+
+        // A whole chunk is written before it is read back, so the line holds one chunk on top of the longest delay
+        const int maxDelaySamples = static_cast<int>(std::ceil(sampleRate * maxDelayMs / 1000.0));
+        const int capacity = DelayLine<SampleType>::getCapacityFor(maxDelaySamples + juce::jmax(1, maximumBlockSize));
+        memory.assign(static_cast<size_t>(juce::jmax(1, numChannels)) * static_cast<size_t>(capacity), SampleType(0));
+        lines.resize(static_cast<size_t>(juce::jmax(1, numChannels)));
+
+        for (size_t channel = 0; channel < lines.size(); ++channel)
+            lines[channel].prepare(memory.data() + channel * static_cast<size_t>(capacity), capacity);
+
+        delays.assign(static_cast<size_t>(juce::jmax(1, maximumBlockSize)), SampleType(0));
+        wet.assign(delays.size(), SampleType(0));
+
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        for (auto& line : lines)
+            line.reset();
+
+        phase = 0.0;
+        currentDepth = depth;
+    }
+
+    void setRate(SampleType newRateHz) noexcept { rate = newRateHz; }
+    void setDepth(SampleType newDepth) noexcept { depth = juce::jlimit(SampleType(0), SampleType(1), newDepth); }
+    void setMix(SampleType newMix) noexcept { mix = juce::jlimit(SampleType(0), SampleType(1), newMix); }
+
+    void setCentreDelay(SampleType newDelayMs) noexcept
+    {
+        centreDelayMs = juce::jlimit(SampleType(1), static_cast<SampleType>(maxDelayMs / (1.0 + sweep)), newDelayMs);
+    }
+
+    /**
+     * @brief Processes the buffer in place, in chunks of at most the prepared block size.
+     */
+    void process(juce::AudioBuffer<SampleType>& buffer) noexcept
+    {
+        const int maxChunk = static_cast<int>(delays.size());
+        const int numChannels = juce::jmin(buffer.getNumChannels(), static_cast<int>(lines.size()));
+
+        for (int start = 0; start < buffer.getNumSamples(); start += maxChunk)
+        {
+            const int numSamples = juce::jmin(maxChunk, buffer.getNumSamples() - start);
+
+            // === Delay times ===
+            const double increment = rate / sampleRate;
+            const SampleType centre = static_cast<SampleType>(centreDelayMs * sampleRate / 1000.0);
+            const SampleType depthStep = (depth - currentDepth) / static_cast<SampleType>(numSamples);
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                currentDepth += depthStep;
+
+                const auto lfo = static_cast<SampleType>(std::sin(juce::MathConstants<double>::twoPi * phase));
+                delays[static_cast<size_t>(i)] = centre * (SampleType(1) + sweep * currentDepth * lfo);
+
+                phase += increment;
+                phase -= std::floor(phase);
+            }
+
+            currentDepth = depth;
+
+            // === Delay and mix, per channel ===
+            for (int channel = 0; channel < numChannels; ++channel)
+            {
+                SampleType* samples = buffer.getWritePointer(channel, start);
+                auto& line = lines[static_cast<size_t>(channel)];
+
+                line.writeBlock(samples, numSamples);
+                line.template readBlock<DelayInterpolation::Linear>(wet.data(), delays.data(), numSamples);
+
+                for (int i = 0; i < numSamples; ++i)
+                    samples[i] += mix * (wet[static_cast<size_t>(i)] - samples[i]);
+            }
+        }
+    }
+
+private:
+    double sampleRate = 44100.0;
+    double phase = 0.0;
+
+    SampleType rate = SampleType(1.5);
+    SampleType depth = SampleType(0.3);
+    SampleType currentDepth = SampleType(0.3);
+    SampleType centreDelayMs = SampleType(10);
+    SampleType mix = SampleType(0.4);
+
+    std::vector<SampleType> memory;
+    std::vector<DelayLine<SampleType>> lines;
+    std::vector<SampleType> delays;
+    std::vector<SampleType> wet;
+};
@@ -0,0 +1,174 @@
+#pragma once
+#include <juce_core/juce_core.h>
+
+#include <algorithm>
+
+
+/**
+ * @brief How a DelayLine reads between two samples
+ */
+enum class DelayInterpolation
+{
+    Linear,     // Cheapest, dulls the highs a little at fractional delays
+    Lagrange,   // Third order, flat enough for feedback loops the signal runs through many times
+    Allpass     // First order Thiran, flat magnitude, but only for delays that move slowly
+};
+
+
+/**
+ * @brief Circular delay line for the comb, the echo and the chorus
+ *
+ * The capacity is a power of two, so wrapping is a mask instead of a modulo. The line does not own its
+ * memory: like everything else in the VoicePool it points into a block allocated in prepareToPlay.
+ *
+ * Delays are given in samples, may be fractional and may change every sample. They are measured from
+ * the sample being processed: read() before push(), or readBlock() right after writeBlock() for the same
+ * block. Linear and allpass reads need a delay of at least 1, Lagrange reads at least 2.
+ */
+template <typename SampleType>
+class DelayLine
+{
+public:
+    /**
+     * @return The smallest power of two capacity that allows delays of up to maxDelaySamples with every interpolation
+     */
+    static int getCapacityFor(int maxDelaySamples) noexcept
+    {
+        return juce::nextPowerOfTwo(juce::jmax(1, maxDelaySamples) + margin);
+    }
+
+    /**
+     * @param memory capacity samples that stay valid until the next prepare
+     * @param capacity A power of two, see getCapacityFor()
+     */
+    void prepare(SampleType* memory, int capacity) noexcept
+    {
+        jassert(juce::isPowerOfTwo(capacity));
+
+        buffer = memory;
+        mask = capacity - 1;
+        wrapped = true;     // Whatever the memory held before counts as written
+        reset();
+    }
+
+    /**
+     * @brief Silences the line. Only the part written since the last reset is cleared,
+     *        so resetting after a short note does not touch the whole capacity.
+     */
+    void reset() noexcept
+    {
+        std::fill(buffer, buffer + (wrapped ? mask + 1 : writePosition), SampleType(0));
+        writePosition = 0;
+        wrapped = false;
+        allpassState = SampleType(0);
+    }
+
+    /**
+     * @return The longest delay that can be read
+     */
+    SampleType getMaximumDelay() const noexcept
+    {
+        return static_cast<SampleType>(mask + 1 - margin);
+    }
+
+    /// === One sample at a time, for feedback loops shorter than a block ===
+
+    template <DelayInterpolation interpolation>
+    SampleType read(SampleType delay) noexcept
+    {
+        return readAt<interpolation>(writePosition, delay);
+    }
+
+    void push(SampleType input) noexcept
+    {
+        buffer[writePosition] = input;
+        writePosition = (writePosition + 1) & mask;
+        wrapped = wrapped || writePosition == 0;
+    }
+
+    /// === Whole blocks, for feed-forward effects ===
+
+    /**
+     * @brief Appends a block, in at most two copies.
+     *
+     * To read the block back with delays up to d, the capacity has to hold numSamples + d, see getCapacityFor().
+     */
+    void writeBlock(const SampleType* input, int numSamples) noexcept
+    {
+        jassert(numSamples <= mask + 1);
+
+        const int firstPart = juce::jmin(numSamples, mask + 1 - writePosition);
+
+        std::copy(input, input + firstPart, buffer + writePosition);
+        std::copy(input + firstPart, input + numSamples, buffer);
+
+        wrapped = wrapped || writePosition + numSamples > mask;
+        writePosition = (writePosition + numSamples) & mask;
+    }
+
+    /**
+     * @brief Reads one delayed sample per sample of the block written last.
+     *
+     * @param output Receives numSamples samples
+     * @param delays Delay of every sample, relative to that sample
+     */
+    template <DelayInterpolation interpolation>
+    void readBlock(SampleType* output, const SampleType* delays, int numSamples) noexcept
+    {
+        const int start = writePosition - numSamples;
+
+        for (int i = 0; i < numSamples; ++i)
+            output[i] = readAt<interpolation>(start + i, delays[i]);
+    }
+
+private:
+    static constexpr int margin = 4;    // Lagrange reads up to two samples beyond the integer delay
+
+    /**
+     * @param position Where the sample the delay is measured from is (or will be) stored, may be out of range
+     */
+    template <DelayInterpolation interpolation>
+    SampleType readAt(int position, SampleType delay) noexcept
+    {
+        const int whole = static_cast<int>(delay);
+        const SampleType fraction = delay - static_cast<SampleType>(whole);
+        const int index = position - whole;
+
+        // Sample at delay whole + offset
+        auto at = [this, index](int offset) noexcept { return buffer[(index - offset) & mask]; };
+
+        if constexpr (interpolation == DelayInterpolation::Linear)
+        {
+            const SampleType a = at(0);
+            return a + fraction * (at(1) - a);
+        }
+        else if constexpr (interpolation == DelayInterpolation::Lagrange)
+        {
+            // Nodes at delay whole - 1 ... whole + 2, t is the read position counted from the first one
+            const SampleType t = fraction + SampleType(1);
+            const SampleType d1 = t - SampleType(1);
+            const SampleType d2 = t - SampleType(2);
+            const SampleType d3 = t - SampleType(3);
+
+            const SampleType c0 = -d1 * d2 * d3 / SampleType(6);
+            const SampleType c1 = d2 * d3 * SampleType(0.5);
+            const SampleType c2 = -d1 * d3 * SampleType(0.5);
+            const SampleType c3 = d1 * d2 / SampleType(6);
+
+            return at(-1) * c0 + t * (at(0) * c1 + at(1) * c2 + at(2) * c3);
+        }
+        else
+        {
+            // A whole delay would put the pole on Nyquist, so that one is read directly
+            const SampleType alpha = (SampleType(1) - fraction) / (SampleType(1) + fraction);
+            allpassState = fraction > SampleType(0) ? at(1) + alpha * (at(0) - allpassState) : at(0);
+            return allpassState;
+        }
+    }
+
+    SampleType* buffer = nullptr;
+    int mask = 0;
+    int writePosition = 0;
+    bool wrapped = false;   // Every sample may be non-zero, not just [0, writePosition)
+    SampleType allpassState = SampleType(0);
+};
@@ -1,23 +1,34 @@
 #pragma once
 #include <juce_gui_basics/juce_gui_basics.h>
 
+#include "PrescaledImage.h"
+
 
 /**
  * @brief A basic Component with a background image and border
+ *
+ * The background is resampled to the panel's size once in resized(), so repaints caused by the
+ * knobs on top of it only blit it.
  */
 class FXPanel : public juce::Component
 {
 public:
+    FXPanel()
+    {
+        setOpaque(true);
+    }
+
     void setImage(juce::Image img)
     {
-        backgroundImage = img;
+        backgroundImage.setSource(img);
+        backgroundImage.update(getLocalBounds(), juce::Component::getApproximateScaleFactorForComponent(this));
         repaint();
     }
 
     void paint(juce::Graphics& g) override
     {
         if (backgroundImage.isValid())
-            g.drawImage(backgroundImage, getLocalBounds().toFloat(), juce::RectanglePlacement::stretchToFit);
+            backgroundImage.draw(g, *this, getLocalBounds());
         else
             g.fillAll(juce::Colours::darkgrey); // fallback
         
@@ -25,6 +36,11 @@ public:
         g.drawRect(getLocalBounds(), 2); // 2 pixels thick
     }
 
+    void resized() override
+    {
+        backgroundImage.update(getLocalBounds(), juce::Component::getApproximateScaleFactorForComponent(this));
+    }
+
 protected:
-    juce::Image backgroundImage;
+    PrescaledImage backgroundImage{ juce::RectanglePlacement::stretchToFit };
 };
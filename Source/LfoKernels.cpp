@@ -0,0 +1,76 @@
+#include "LfoKernels.h"
+
+
+void Lfo::sinTurns(float* phases, int numSamples) noexcept
+{
+    using Vec = juce::dsp::SIMDRegister<float>;
+    constexpr int lanes = static_cast<int>(Vec::size());
+
+    // Scalar head until the buffer is aligned, SIMD body, scalar tail
+    float* aligned = juce::jmin(Vec::getNextSIMDAlignedPtr(phases), phases + numSamples);
+    int i = 0;
+
+    for (; phases + i < aligned; ++i)
+        phases[i] = sinTurns(phases[i]);
+
+    const Vec half = Vec::expand(0.5f);
+    const Vec minusHalf = Vec::expand(-0.5f);
+
+    for (; i + lanes <= numSamples; i += lanes)
+    {
+        const Vec y = half - Vec::fromRawArray(phases + i);
+        const Vec folded = Vec::max(Vec::min(y, half - y), minusHalf - y);
+
+        sinPolynomial(folded).copyToRawArray(phases + i);
+    }
+
+    for (; i < numSamples; ++i)
+        phases[i] = sinTurns(phases[i]);
+}
+
+void Lfo::renderSine(float* output, double& phase, const ParameterRamp& rate, const ParameterRamp& depth,
+                     int startSample, int numSamples, double sampleRate) noexcept
+{
+    if (numSamples <= 0)
+        return;
+
+    const double inverseSampleRate = 1.0 / sampleRate;
+
+    // === Phases ===
+    // Accumulated in double and only rounded to float per sample, the sine itself does not need more
+    if (!rate.ramping)
+    {
+        // Computed directly from the block start, so this loop has no carried dependency and vectorises
+        const double increment = rate.constant * inverseSampleRate;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const double p = phase + static_cast<double>(i) * increment;
+            output[i] = static_cast<float>(p - static_cast<double>(static_cast<int>(p)));
+        }
+
+        const double next = phase + static_cast<double>(numSamples) * increment;
+        phase = next - static_cast<double>(static_cast<int>(next));
+    }
+    else
+    {
+        double p = phase;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            output[i] = static_cast<float>(p);
+            p += rate[startSample + i] * inverseSampleRate;
+            p -= (p >= 1.0) ? 1.0 : 0.0;
+        }
+
+        phase = p;
+    }
+
+    // === Sine and depth ===
+    sinTurns(output, numSamples);
+
+    if (depth.ramping)
+        juce::FloatVectorOperations::multiply(output, depth.values + startSample, numSamples);
+    else
+        juce::FloatVectorOperations::multiply(output, depth.constant, numSamples);
+}
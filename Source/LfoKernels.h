@@ -0,0 +1,59 @@
+#pragma once
+#include <juce_dsp/juce_dsp.h>
+
+#include "ParameterSmoother.h"
+
+
+/**
+ * @brief Block-rate LFOs for vibrato, tremolo and chirp
+ *
+ * Instead of one std::sin and one wrapped phase update per sample and LFO, a whole block of
+ * modulation values is produced at once. The phases are accumulated first, then the sine is
+ * evaluated with a polynomial on juce::dsp::SIMDRegister, which maps to SSE, AVX or NEON
+ * depending on the target.
+ */
+namespace Lfo
+{
+    /**
+     * @brief Odd polynomial for sin(2 pi y), y in [-0.25, 0.25] turns. Works on floats and SIMDRegisters
+     */
+    template <typename Type>
+    inline Type sinPolynomial(Type y) noexcept
+    {
+        const Type z = y * juce::MathConstants<float>::twoPi;
+        const Type z2 = z * z;
+
+        return z * ((((z2 * (1.0f / 362880.0f) + (-1.0f / 5040.0f)) * z2 + (1.0f / 120.0f)) * z2 + (-1.0f / 6.0f)) * z2 + 1.0f);
+    }
+
+    /**
+     * @brief Scalar sin(2 pi phase) with an absolute error below 4e-6.
+     *
+     * @param phase Phase in turns (0..1)
+     */
+    inline float sinTurns(float phase) noexcept
+    {
+        // sin(2 pi p) = sin(2 pi (0.5 - p)), then fold onto the quarter wave around zero
+        const float y = 0.5f - phase;
+        return sinPolynomial(juce::jmax(juce::jmin(y, 0.5f - y), -0.5f - y));
+    }
+
+    /**
+     * @brief Replaces every phase (0..1) in the block by sin(2 pi phase), using SIMD where the buffer allows.
+     */
+    void sinTurns(float* phases, int numSamples) noexcept;
+
+    /**
+     * @brief Writes depth * sin(2 pi phase) for every sample of the block and advances the phase.
+     *
+     * @param output Receives numSamples values
+     * @param phase Phase of the LFO in turns, updated to the start of the next block
+     * @param rate LFO rate in Hz
+     * @param depth Modulation depth
+     * @param startSample Position of the block inside the host block, used to index the ramps
+     * @param numSamples Number of values to produce
+     * @param sampleRate The current sample rate
+     */
+    void renderSine(float* output, double& phase, const ParameterRamp& rate, const ParameterRamp& depth,
+                    int startSample, int numSamples, double sampleRate) noexcept;
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include <juce_dsp/juce_dsp.h>
+
+
+/**
+ * @brief Topology-preserving state variable filter for cutoffs that move every sample
+ *
+ * Same structure and response as juce::dsp::StateVariableTPTFilter, but built for envelope sweeps:
+ *  - the coefficients are only recomputed when cutoff or resonance actually change
+ *  - tan() is replaced by a rational approximation (relative error below 1e-6 up to 0.3 * sample rate)
+ *  - setting both parameters costs a single update instead of two
+ *
+ * SampleType may be a juce::dsp::SIMDRegister, in which case every lane is an independent channel
+ * sharing the same cutoff and resonance.
+ */
+template <typename SampleType>
+class ModulatedSvf
+{
+public:
+    using NumericType = typename juce::dsp::SampleTypeHelpers::ElementType<SampleType>::Type;
+
+    enum class Type { lowpass, bandpass, highpass };
+
+    /**
+     * @brief tan(x) for x in [0, pi/2), Padé approximant of order [5/4]
+     */
+    static NumericType fastTan(NumericType x) noexcept
+    {
+        const NumericType x2 = x * x;
+        return x * (NumericType(945) - NumericType(105) * x2 + x2 * x2)
+                 / (NumericType(945) - NumericType(420) * x2 + NumericType(15) * x2 * x2);
+    }
+
+    void prepare(double sampleRate) noexcept
+    {
+        piOverSampleRate = static_cast<NumericType>(juce::MathConstants<double>::pi / sampleRate);
+        maxCutoff = static_cast<NumericType>(0.49 * sampleRate);
+        update();
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        s1 = SampleType(0);
+        s2 = SampleType(0);
+    }
+
+    void setType(Type newType) noexcept { type = newType; }
+
+    void setCutoffFrequency(NumericType newCutoff) noexcept { setParameters(newCutoff, resonance); }
+    void setResonance(NumericType newResonance) noexcept { setParameters(cutoff, newResonance); }
+
+    /**
+     * @brief Sets cutoff (Hz) and resonance, recomputing the coefficients only if one of them changed.
+     */
+    void setParameters(NumericType newCutoff, NumericType newResonance) noexcept
+    {
+        if (newCutoff == cutoff && newResonance == resonance)
+            return;
+
+        cutoff = newCutoff;
+        resonance = newResonance;
+        update();
+    }
+
+    SampleType processSample(SampleType input) noexcept
+    {
+        const SampleType highpass = (input - s1 * (g + R2) - s2) * h;
+
+        const SampleType bandpass = highpass * g + s1;
+        s1 = highpass * g + bandpass;
+
+        const SampleType lowpass = bandpass * g + s2;
+        s2 = bandpass * g + lowpass;
+
+        switch (type)
+        {
+            case Type::lowpass:  return lowpass;
+            case Type::highpass: return highpass;
+            case Type::bandpass: break;
+        }
+
+        return bandpass;
+    }
+
+private:
+    void update() noexcept
+    {
+        g = fastTan(juce::jlimit(NumericType(0), maxCutoff, cutoff) * piOverSampleRate);
+        R2 = NumericType(1) / resonance;
+        h = NumericType(1) / (NumericType(1) + R2 * g + g * g);
+    }
+
+    Type type = Type::bandpass;
+
+    NumericType cutoff = NumericType(1000), resonance = NumericType(1) / juce::MathConstants<NumericType>::sqrt2;
+    NumericType piOverSampleRate = NumericType(juce::MathConstants<double>::pi / 44100.0), maxCutoff = NumericType(21609);
+    NumericType g = NumericType(0), R2 = NumericType(0), h = NumericType(0);
+
+    SampleType s1{}, s2{};
+};
@@ -0,0 +1,261 @@
+#include "Oversampler.h"
+
+#include <cmath>
+
+
+namespace
+{
+    /**
+     * @brief Number of allpass coefficients and normalised transition bandwidth of one 2x stage
+     */
+    struct StageSpec
+    {
+        int numCoefficients;
+        double transitionBandwidth;
+    };
+
+    // The first stage next to the base rate has to be steep, later ones only need to keep the images
+    // of the already band-limited signal out, so their transition band can be much wider.
+    // Every stage keeps the same passband (0.4 or 0.48 of the base sample rate) and roughly the same rejection.
+    constexpr std::array<StageSpec, Oversampler::maxStages> realtimeSpecs{{ { 6, 0.1 }, { 3, 0.3 }, { 2, 0.4 } }};
+    constexpr std::array<StageSpec, Oversampler::maxStages> offlineSpecs{{ { 12, 0.02 }, { 4, 0.25 }, { 3, 0.37 } }};
+
+    struct CoefficientSet
+    {
+        std::array<std::array<float, Oversampler::maxCoefficients>, Oversampler::maxStages> coefficients{};
+        std::array<int, Oversampler::maxStages> numCoefficients{};
+    };
+
+    double power(double x, int exponent)
+    {
+        double result = 1.0;
+
+        for (; exponent > 0; exponent >>= 1, x *= x)
+            if (exponent & 1)
+                result *= x;
+
+        return result;
+    }
+
+    /**
+     * @brief Allpass coefficients of an elliptic half-band filter in polyphase form.
+     *
+     * The classic closed-form design via the elliptic nome q (see Valenzuela & Constantinides, "Digital
+     * signal processing schemes for efficient interpolation and decimation"). Even coefficients belong
+     * to the first allpass chain, odd ones to the second.
+     */
+    void design(float* coefficients, int numCoefficients, double transitionBandwidth)
+    {
+        const double pi = juce::MathConstants<double>::pi;
+
+        double k = std::tan((1.0 - transitionBandwidth * 2.0) * pi / 4.0);
+        k *= k;
+
+        const double kksqrt = std::pow(1.0 - k * k, 0.25);
+        const double e = 0.5 * (1.0 - kksqrt) / (1.0 + kksqrt);
+        const double e4 = e * e * e * e;
+        const double q = e * (1.0 + e4 * (2.0 + e4 * (15.0 + 150.0 * e4)));
+
+        const int order = numCoefficients * 2 + 1;
+
+        for (int index = 0; index < numCoefficients; ++index)
+        {
+            const int c = index + 1;
+
+            double numerator = 0.0;
+            double term = 0.0;
+
+            for (int i = 0, sign = 1; i == 0 || std::abs(term) > 1.0e-100; ++i, sign = -sign)
+            {
+                term = power(q, i * (i + 1)) * std::sin((i * 2 + 1) * c * pi / order) * sign;
+                numerator += term;
+            }
+
+            double denominator = 0.0;
+
+            for (int i = 1, sign = -1; i == 1 || std::abs(term) > 1.0e-100; ++i, sign = -sign)
+            {
+                term = power(q, i * i) * std::cos(i * 2 * c * pi / order) * sign;
+                denominator += term;
+            }
+
+            const double ww = numerator * std::pow(q, 0.25) / (denominator + 0.5);
+            const double wwsq = ww * ww;
+            const double x = std::sqrt((1.0 - wwsq * k) * (1.0 - wwsq / k)) / (1.0 + wwsq);
+
+            coefficients[index] = static_cast<float>((1.0 - x) / (1.0 + x));
+        }
+    }
+
+    CoefficientSet designSet(const std::array<StageSpec, Oversampler::maxStages>& specs)
+    {
+        CoefficientSet set;
+
+        for (size_t stage = 0; stage < specs.size(); ++stage)
+        {
+            jassert(specs[stage].numCoefficients <= Oversampler::maxCoefficients);
+
+            set.numCoefficients[stage] = specs[stage].numCoefficients;
+            design(set.coefficients[stage].data(), specs[stage].numCoefficients, specs[stage].transitionBandwidth);
+        }
+
+        return set;
+    }
+
+    /**
+     * @brief Designed once per process, on first use
+     */
+    const CoefficientSet& getCoefficients(OversamplingQuality quality)
+    {
+        static const CoefficientSet realtime = designSet(realtimeSpecs);
+        static const CoefficientSet offline = designSet(offlineSpecs);
+
+        return quality == OversamplingQuality::Offline ? offline : realtime;
+    }
+
+    /**
+     * @brief First-order allpass at the lower rate, (a + z^-1) / (1 + a z^-1)
+     */
+    inline float allpass(float input, float coefficient, float& x1, float& y1) noexcept
+    {
+        const float output = (input - y1) * coefficient + x1;
+        x1 = input;
+        y1 = output;
+        return output;
+    }
+}
+
+
+//==============================================================================
+void Oversampler::Stage::upsample(const float* input, float* output, int numSamples) noexcept
+{
+    for (int i = 0; i < numSamples; ++i)
+    {
+        float even = input[i];
+        float odd = input[i];
+
+        for (int c = 0; c < numCoefficients; c += 2)
+        {
+            even = allpass(even, coefficients[c], upX[static_cast<size_t>(c)], upY[static_cast<size_t>(c)]);
+
+            if (c + 1 < numCoefficients)
+                odd = allpass(odd, coefficients[c + 1], upX[static_cast<size_t>(c + 1)], upY[static_cast<size_t>(c + 1)]);
+        }
+
+        output[2 * i] = even;
+        output[2 * i + 1] = odd;
+    }
+}
+
+void Oversampler::Stage::downsample(const float* input, float* output, int numSamples) noexcept
+{
+    for (int i = 0; i < numSamples; ++i)
+    {
+        float first = input[2 * i + 1];
+        float second = input[2 * i];
+
+        for (int c = 0; c < numCoefficients; c += 2)
+        {
+            first = allpass(first, coefficients[c], downX[static_cast<size_t>(c)], downY[static_cast<size_t>(c)]);
+
+            if (c + 1 < numCoefficients)
+                second = allpass(second, coefficients[c + 1], downX[static_cast<size_t>(c + 1)], downY[static_cast<size_t>(c + 1)]);
+        }
+
+        output[i] = 0.5f * (first + second);
+    }
+}
+
+void Oversampler::Stage::reset() noexcept
+{
+    upX.fill(0.0f);
+    upY.fill(0.0f);
+    downX.fill(0.0f);
+    downY.fill(0.0f);
+}
+
+
+//==============================================================================
+void Oversampler::prepareCoefficients()
+{
+    getCoefficients(OversamplingQuality::Realtime);
+    getCoefficients(OversamplingQuality::Offline);
+}
+
+/**
+ * @brief Hands the oversampler its buffers and falls back to no oversampling.
+ *
+ * @param workspace getWorkspaceSize(maximumBlockSize) floats that stay valid until the next prepare
+ * @param maximumBlockSize The largest block upsample() will be called with
+ */
+void Oversampler::prepare(float* workspace, int maximumBlockSize) noexcept
+{
+    blockSize = maximumBlockSize;
+    bufferA = workspace;
+    bufferB = workspace + maxFactor * maximumBlockSize;
+
+    numStages = 0;
+    currentQuality = OversamplingQuality::Realtime;
+    reset();
+}
+
+void Oversampler::setup(int factor, OversamplingQuality quality) noexcept
+{
+    int newNumStages = 0;
+
+    while (newNumStages < maxStages && (2 << newNumStages) <= factor)
+        ++newNumStages;
+
+    if (newNumStages == numStages && quality == currentQuality)
+        return;
+
+    numStages = newNumStages;
+    currentQuality = quality;
+
+    const auto& set = getCoefficients(quality);
+
+    for (size_t stage = 0; stage < stages.size(); ++stage)
+    {
+        stages[stage].coefficients = set.coefficients[stage].data();
+        stages[stage].numCoefficients = set.numCoefficients[stage];
+    }
+
+    reset();
+}
+
+void Oversampler::reset() noexcept
+{
+    for (auto& stage : stages)
+        stage.reset();
+}
+
+// Stage k writes into bufferA if it is an even number of stages away from the last one, otherwise into bufferB,
+// so the fully oversampled block always ends up in bufferA. Downsampling walks the same buffers backwards.
+
+float* Oversampler::upsample(float* block, int numSamples) noexcept
+{
+    jassert(numSamples <= blockSize);
+
+    const float* input = block;
+    float* output = block;
+
+    for (int stage = 0; stage < numStages; ++stage)
+    {
+        output = (numStages - 1 - stage) % 2 == 0 ? bufferA : bufferB;
+        stages[static_cast<size_t>(stage)].upsample(input, output, numSamples << stage);
+        input = output;
+    }
+
+    return output;
+}
+
+void Oversampler::downsample(float* block, int numSamples) noexcept
+{
+    for (int stage = numStages - 1; stage >= 0; --stage)
+    {
+        const float* input = (numStages - 1 - stage) % 2 == 0 ? bufferA : bufferB;
+        float* output = stage == 0 ? block : ((numStages - stage) % 2 == 0 ? bufferA : bufferB);
+
+        stages[static_cast<size_t>(stage)].downsample(input, output, numSamples << stage);
+    }
+}
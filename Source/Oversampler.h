@@ -0,0 +1,100 @@
+#pragma once
+#include <juce_core/juce_core.h>
+
+#include <array>
+
+
+/**
+ * @brief Which set of half-band filters the Oversampler uses
+ */
+enum class OversamplingQuality
+{
+    Realtime,   // Short filters, about 100 dB image and alias rejection up to 0.4 * sample rate
+    Offline     // Long filters, about 120 dB up to 0.48 * sample rate, for bounces and AnimalRender
+};
+
+
+/**
+ * @brief 2x, 4x or 8x oversampling for a mono block, built from cascaded polyphase IIR half-band stages
+ *
+ * Every 2x stage is a pair of allpass chains running at the lower rate (the polyphase form of an elliptic
+ * half-band lowpass), so up- and downsampling cost a handful of multiplies per sample and stage, and only
+ * the first stage next to the base rate needs a steep filter. The filters are minimum phase-ish IIRs,
+ * which adds a few samples of group delay but no reported latency.
+ *
+ * The oversampler owns no memory: prepare() hands it a slice of the VoicePool's sample memory that is
+ * large enough for the highest factor, so switching the factor never allocates.
+ */
+class Oversampler
+{
+public:
+    static constexpr int maxStages = 3;
+    static constexpr int maxFactor = 1 << maxStages;
+    static constexpr int maxCoefficients = 12;
+
+    /**
+     * @return How many floats of workspace prepare() needs for blocks of up to maximumBlockSize samples
+     */
+    static constexpr int getWorkspaceSize(int maximumBlockSize) noexcept
+    {
+        return (maxFactor + maxFactor / 2) * maximumBlockSize;
+    }
+
+    /**
+     * @brief Designs the half-band coefficients of both qualities. Done on first use otherwise
+     */
+    static void prepareCoefficients();
+
+    void prepare(float* workspace, int maximumBlockSize) noexcept;
+
+    /**
+     * @brief Picks factor and filters. Clears the filter state if either changed.
+     *
+     * @param factor 1, 2, 4 or 8, anything else is rounded down to one of those
+     */
+    void setup(int factor, OversamplingQuality quality) noexcept;
+
+    int getFactor() const noexcept { return 1 << numStages; }
+    int getNumStages() const noexcept { return numStages; }
+
+    void reset() noexcept;
+
+    /**
+     * @brief Upsamples a block into the workspace.
+     *
+     * @param block numSamples samples at the base rate
+     * @return numSamples * getFactor() samples at the oversampled rate. With a factor of 1 that is block itself
+     */
+    float* upsample(float* block, int numSamples) noexcept;
+
+    /**
+     * @brief Filters and decimates the block upsample() returned back into block.
+     *
+     * @param block Receives numSamples samples at the base rate
+     */
+    void downsample(float* block, int numSamples) noexcept;
+
+private:
+    /**
+     * @brief One 2x stage: the allpass states of its up- and its downsampler
+     */
+    struct Stage
+    {
+        const float* coefficients = nullptr;
+        int numCoefficients = 0;
+
+        std::array<float, maxCoefficients> upX{}, upY{}, downX{}, downY{};
+
+        void upsample(const float* input, float* output, int numSamples) noexcept;
+        void downsample(const float* input, float* output, int numSamples) noexcept;
+        void reset() noexcept;
+    };
+
+    std::array<Stage, maxStages> stages;
+    int numStages = 0;
+    OversamplingQuality currentQuality = OversamplingQuality::Realtime;
+
+    float* bufferA = nullptr;   // maxFactor * blockSize, always holds the fully oversampled block
+    float* bufferB = nullptr;   // maxFactor / 2 * blockSize, intermediate rates
+    int blockSize = 0;
+};
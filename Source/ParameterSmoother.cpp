@@ -0,0 +1,145 @@
+#include "ParameterSmoother.h"
+
+
+/**
+ * @brief Allocates the ramp vectors and jumps every smoother to the current parameter value.
+ *
+ * @param sampleRate The current sample rate
+ * @param maximumBlockSize The largest block the host will ask for
+ * @param handles The processor's cached parameter handles
+ */
+void ParameterSmoother::prepare(double sampleRate, int maximumBlockSize, const ParameterHandles& handles)
+{
+    blockSize = juce::jmax(1, maximumBlockSize);
+    rampMemory.assign(smoothedParameters.size() * static_cast<size_t>(blockSize), 0.0f);
+
+    for (size_t i = 0; i < smoothedParameters.size(); ++i)
+    {
+        const auto p = static_cast<size_t>(smoothedParameters[i]);
+
+        smoothers[p].reset(sampleRate, rampLengthSeconds);
+        rampStorage[p] = rampMemory.data() + i * static_cast<size_t>(blockSize);
+    }
+
+    for (const auto& spec : parameterTable)
+    {
+        const auto p = static_cast<size_t>(spec.param);
+        const float value = handles.get(spec.param);
+
+        smoothers[p].setCurrentAndTargetValue(value);
+        ramps[p] = { rampStorage[p], value, false };
+        hostValues[p] = value;
+        heldByEvent[p] = false;
+    }
+}
+
+/**
+ * @brief Updates all ramps for the next block.
+ *
+ * @param handles The processor's cached parameter handles
+ * @param numSamples Length of the block about to be rendered
+ */
+void ParameterSmoother::process(const ParameterHandles& handles, int numSamples) noexcept
+{
+    for (const auto& spec : parameterTable)
+    {
+        const auto p = static_cast<size_t>(spec.param);
+        auto& ramp = ramps[p];
+        const float hostValue = handles.get(spec.param);
+
+        if (hostValue != hostValues[p])
+            heldByEvent[p] = false;
+
+        hostValues[p] = hostValue;
+        const float target = heldByEvent[p] ? eventValues[p] : hostValue;
+
+        // Not smoothed at all: block-rate constant
+        if (rampStorage[p] == nullptr)
+        {
+            ramp.constant = target;
+            continue;
+        }
+
+        auto& smoother = smoothers[p];
+        smoother.setTargetValue(target);
+
+        if (!smoother.isSmoothing())
+        {
+            ramp.constant = target;
+            ramp.ramping = false;
+            continue;
+        }
+
+        if (numSamples <= 0 || numSamples > blockSize)
+        {
+            // Nothing to ramp over (or a block we were not prepared for), so just jump
+            smoother.setCurrentAndTargetValue(target);
+            ramp.constant = target;
+            ramp.ramping = false;
+            continue;
+        }
+
+        float* values = rampStorage[p];
+
+        for (int i = 0; i < numSamples; ++i)
+            values[i] = smoother.getNextValue();
+
+        ramp.constant = values[numSamples - 1];
+        ramp.ramping = true;
+    }
+}
+
+/**
+ * @brief Changes a parameter from a given sample of the current block onwards.
+ *
+ * Used for sample-accurate parameter events. The samples before the event keep their values,
+ * smoothed parameters ramp towards the new value from the event position on.
+ * The value is kept as the target of later blocks until the host changes the parameter itself.
+ *
+ * @param param The parameter to change
+ * @param value The new (plain) value
+ * @param samplePosition Position of the event inside the current block
+ * @param numSamples Length of the current block
+ */
+void ParameterSmoother::applyEvent(ParamId param, float value, int samplePosition, int numSamples) noexcept
+{
+    const auto p = static_cast<size_t>(param);
+    auto& ramp = ramps[p];
+    float* values = rampStorage[p];
+
+    eventValues[p] = value;
+    heldByEvent[p] = true;
+
+    if (values == nullptr)
+    {
+        ramp.constant = value;
+        return;
+    }
+
+    auto& smoother = smoothers[p];
+
+    if (numSamples <= 0 || numSamples > blockSize)
+    {
+        smoother.setCurrentAndTargetValue(value);
+        ramp.constant = value;
+        ramp.ramping = false;
+        return;
+    }
+
+    const int start = juce::jlimit(0, numSamples, samplePosition);
+
+    // Keep everything before the event as it was
+    if (!ramp.ramping)
+        std::fill(values, values + start, ramp.constant);
+
+    const float valueAtEvent = start > 0 ? values[start - 1] : ramp[0];
+
+    smoother.setCurrentAndTargetValue(valueAtEvent);
+    smoother.setTargetValue(value);
+
+    for (int i = start; i < numSamples; ++i)
+        values[i] = smoother.getNextValue();
+
+    ramp.constant = values[numSamples - 1];
+    ramp.ramping = true;
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include <juce_audio_basics/juce_audio_basics.h>
+
+#include "ParameterTable.h"
+
+#include <array>
+#include <vector>
+
+
+/**
+ * @brief One block worth of values for a single parameter
+ *
+ * While the parameter is stable this is just a constant and no per-sample values are computed.
+ * Index it with the sample position inside the current host block.
+ */
+struct ParameterRamp
+{
+    const float* values = nullptr;
+    float constant = 0.0f;
+    bool ramping = false;
+
+    float operator[](int sample) const noexcept { return ramping ? values[sample] : constant; }
+};
+
+/**
+ * @brief Continuous parameters that are modulated per sample and therefore need smoothing
+ *
+ * Everything else (ADSR times, bit depths, glide settings, ...) is only read at note-on or per block.
+ */
+inline constexpr std::array<ParamId, 16> smoothedParameters
+{
+    ParamId::vibratoRate, ParamId::vibratoDepth, ParamId::tremoloRate, ParamId::tremoloDepth,
+    ParamId::sawCombTime, ParamId::sawCombFeedback, ParamId::formantFreq, ParamId::formantResonance, ParamId::sawDrive, ParamId::sawShape,
+    ParamId::barkFilterFreq, ParamId::barkFilterResonance,
+    ParamId::triChirpRate, ParamId::triChirpDepth, ParamId::triEchoTime, ParamId::triEchoMix
+};
+
+
+/**
+ * @brief Turns knob moves into per-sample ramps instead of block-wide steps
+ *
+ * Once per block, process() computes a whole ramp vector for every smoothed parameter that is
+ * still moving. Parameters that are stable cost nothing beyond one comparison.
+ */
+class ParameterSmoother
+{
+public:
+    static constexpr double rampLengthSeconds = 0.02;
+
+    void prepare(double sampleRate, int maximumBlockSize, const ParameterHandles& handles);
+    void process(const ParameterHandles& handles, int numSamples) noexcept;
+    void applyEvent(ParamId param, float value, int samplePosition, int numSamples) noexcept;
+
+    const ParameterRamp& get(ParamId param) const noexcept { return ramps[static_cast<size_t>(param)]; }
+
+private:
+    std::array<juce::SmoothedValue<float>, numParameters> smoothers;
+    std::array<ParameterRamp, numParameters> ramps;
+    std::array<float*, numParameters> rampStorage{};
+
+    // A scheduled event holds its value until the host moves the parameter away from hostValues
+    std::array<float, numParameters> hostValues{};
+    std::array<float, numParameters> eventValues{};
+    std::array<bool, numParameters> heldByEvent{};
+    std::vector<float> rampMemory;
+    int blockSize = 0;
+};
@@ -0,0 +1,45 @@
+#include "ParameterTable.h"
+
+
+/**
+ * @brief Builds the AudioProcessorValueTreeState layout from the parameterTable.
+ *
+ * @return One AudioParameterChoice or AudioParameterFloat per table entry
+ */
+juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout()
+{
+    juce::AudioProcessorValueTreeState::ParameterLayout layout;
+
+    for (const auto& spec : parameterTable)
+    {
+        if (spec.choices != nullptr)
+        {
+            layout.add(std::make_unique<juce::AudioParameterChoice>(
+                spec.id, spec.name,
+                juce::StringArray::fromTokens(spec.choices, "|", {}),
+                static_cast<int>(spec.defaultValue)
+            ));
+        }
+        else
+        {
+            layout.add(std::make_unique<juce::AudioParameterFloat>(
+                spec.id, spec.name,
+                juce::NormalisableRange<float>(spec.minValue, spec.maxValue, spec.step),
+                spec.defaultValue
+            ));
+        }
+    }
+
+    return layout;
+}
+
+ParameterHandles::ParameterHandles(juce::AudioProcessorValueTreeState& state)
+{
+    for (const auto& spec : parameterTable)
+    {
+        auto* raw = state.getRawParameterValue(spec.id);
+        jassert(raw != nullptr); // every table entry must be part of the layout
+
+        handles[static_cast<size_t>(spec.param)] = raw;
+    }
+}
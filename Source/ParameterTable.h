@@ -0,0 +1,170 @@
+#pragma once
+#include <juce_audio_processors/juce_audio_processors.h>
+
+#include <array>
+#include <atomic>
+
+
+/**
+ * @brief Every parameter of the plugin, in the order of the table below
+ */
+enum class ParamId : int
+{
+    waveform,
+
+    // === ADSR ===
+    attack, decay, sustain, release,
+
+    // === Sine ===
+    vibratoRate, vibratoDepth, sineChorusRate, sineChorusDepth, tremoloDepth, tremoloRate,
+
+    // === Saw ===
+    sawCombTime, sawCombFeedback, formantFreq, formantResonance, sawDrive, sawShape, sawCurve,
+
+    // === Square ===
+    squarePunchAmount, squarePunchDecay, squareBitcrushRate, squareBitcrushDepth, barkFilterFreq, barkFilterResonance,
+
+    // === Triangle ===
+    triGlideTime, triGlideDepth, triChirpRate, triChirpDepth, triEchoTime, triEchoMix,
+
+    // === Oscillators ===
+    oscAntialiasing, oscEngine,
+
+    // === Oversampling ===
+    oversampling, oversamplingOffline,
+
+    count
+};
+
+constexpr int numParameters = static_cast<int>(ParamId::count);
+
+
+/**
+ * @brief Compile-time description of a single parameter
+ *
+ * A choice parameter uses min/max as the index range and lists its options in choices, separated by '|'.
+ */
+struct ParameterSpec
+{
+    ParamId param;
+    const char* id;
+    const char* name;
+    float minValue;
+    float maxValue;
+    float step;             // 0 = continuous
+    float defaultValue;
+    const char* choices = nullptr;
+};
+
+/**
+ * @brief The single source of truth for IDs, ranges and defaults
+ */
+inline constexpr std::array<ParameterSpec, numParameters> parameterTable
+{{
+    { ParamId::waveform,            "waveform",            "Waveform",          0.0f,   3.0f,    1.0f,  0.0f, "Sine|Saw|Square|Triangle" },
+
+    // === ADSR Params ===
+    { ParamId::attack,              "attack",              "Attack",            0.01f,  1.0f,    0.0f,  0.1f },
+    { ParamId::decay,               "decay",               "Decay",             0.01f,  1.0f,    0.0f,  0.2f },
+    { ParamId::sustain,             "sustain",             "Sustain",           0.0f,   1.0f,    0.0f,  0.8f },
+    { ParamId::release,             "release",             "Release",           0.01f,  3.0f,    0.0f,  0.5f },
+
+    // === Sine Params ===
+    { ParamId::vibratoRate,         "vibratoRate",         "Vibrato Rate",      0.0f,   10.0f,   0.0f,  5.0f },
+    { ParamId::vibratoDepth,        "vibratoDepth",        "Vibrato Depth",     0.0f,   0.05f,   0.0f,  0.001f },
+    { ParamId::sineChorusRate,      "sineChorusRate",      "Chorus Rate",       0.0f,   10.0f,   0.0f,  1.5f },
+    { ParamId::sineChorusDepth,     "sineChorusDepth",     "Chorus Depth",      0.0f,   1.0f,    0.0f,  0.3f },
+    { ParamId::tremoloDepth,        "tremoloDepth",        "Tremolo Depth",     0.0f,   1.0f,    0.0f,  0.5f },
+    { ParamId::tremoloRate,         "tremoloRate",         "Tremolo Rate",      0.0f,   20.0f,   0.0f,  4.0f },
+
+    // === Saw Params ===
+    { ParamId::sawCombTime,         "sawCombTime",         "Comb Delay Time",   1.0f,   30.0f,   0.1f,  10.0f },  // milliseconds
+    { ParamId::sawCombFeedback,     "sawCombFeedback",     "Comb Feedback",     0.0f,   0.70f,   0.01f, 0.25f },
+    { ParamId::formantFreq,         "formantFreq",         "Formant Frequency", 200.0f, 2000.0f, 1.0f,  800.0f },
+    { ParamId::formantResonance,    "formantResonance",    "Formant Resonance", 0.0f,   2.5f,    0.01f, 1.0f },
+    { ParamId::sawDrive,            "sawDrive",            "Drive",             0.9f,   10.0f,   0.1f,  3.0f },
+    { ParamId::sawShape,            "sawShape",            "Shape",             0.0f,   1.0f,    0.01f, 0.5f },
+    { ParamId::sawCurve,            "sawCurve",            "Curve",             0.0f,   2.0f,    1.0f,  0.0f, "Clip|Foldback|Tube" },
+
+    // === Square Params ===
+    { ParamId::squarePunchAmount,   "squarePunchAmount",   "Punch Amount",      0.0f,   1.0f,    0.01f, 0.7f },
+    { ParamId::squarePunchDecay,    "squarePunchDecay",    "Punch Decay",       0.01f,  0.3f,    0.01f, 0.05f },
+    { ParamId::squareBitcrushRate,  "squareBitcrushRate",  "Bitcrush Rate",     100.0f, 8000.0f, 1.0f,  10000.0f }, // Hz
+    { ParamId::squareBitcrushDepth, "squareBitcrushDepth", "Bitcrush Depth",    1.0f,   16.0f,   1.0f,  16.0f },    // Bits
+    { ParamId::barkFilterFreq,      "barkFilterFreq",      "Bark Freq",         300.0f, 3000.0f, 1.0f,  800.0f },
+    { ParamId::barkFilterResonance, "barkFilterResonance", "Bark Res",          0.1f,   2.0f,    0.01f, 1.0f },
+
+    // === Triangle Params ===
+    { ParamId::triGlideTime,        "triGlideTime",        "Glide Time",        0.0f,   0.2f,    0.0f,  0.05f },
+    { ParamId::triGlideDepth,       "triGlideDepth",       "Glide Depth",       1.0f,   24.0f,   1.0f,  12.0f },    // semitones
+    { ParamId::triChirpRate,        "triChirpRate",        "Chirp Rate",        1.0f,   50.0f,   0.1f,  20.0f },    // Hz
+    { ParamId::triChirpDepth,       "triChirpDepth",       "Chirp Depth",       0.0f,   1.0f,    0.01f, 0.5f },
+    { ParamId::triEchoTime,         "triEchoTime",         "Echo Time",         10.0f,  250.0f,  1.0f,  80.0f },
+    { ParamId::triEchoMix,          "triEchoMix",          "Echo Mix",          0.0f,   1.0f,    0.01f, 0.3f },
+
+    // === Oscillator Params ===
+    { ParamId::oscAntialiasing,     "oscAntialiasing",     "Antialiasing",      0.0f,   2.0f,    1.0f,  1.0f, "Off|PolyBLEP|MinBLEP" },
+    { ParamId::oscEngine,           "oscEngine",           "Oscillator Engine", 0.0f,   1.0f,    1.0f,  0.0f, "Analytic|Wavetable" },
+
+    // === Oversampling Params ===
+    { ParamId::oversampling,        "oversampling",        "Oversampling",      0.0f,   3.0f,    1.0f,  1.0f, "1x|2x|4x|8x" },
+    { ParamId::oversamplingOffline, "oversamplingOffline", "Offline Oversampling", 0.0f, 3.0f,   1.0f,  2.0f, "1x|2x|4x|8x" },  // While the host bounces
+}};
+
+constexpr bool isParameterTableInOrder()
+{
+    for (int i = 0; i < numParameters; ++i)
+        if (static_cast<int>(parameterTable[static_cast<size_t>(i)].param) != i)
+            return false;
+
+    return true;
+}
+
+static_assert(isParameterTableInOrder(), "parameterTable must list the parameters in ParamId order");
+
+constexpr const ParameterSpec& getParameterSpec(ParamId param)
+{
+    return parameterTable[static_cast<size_t>(param)];
+}
+
+/**
+ *
+ * @return The string ID used by the AudioProcessorValueTreeState and the host
+ */
+constexpr const char* getParameterID(ParamId param)
+{
+    return getParameterSpec(param).id;
+}
+
+juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
+
+
+/**
+ * @brief Typed, cached pointers to the raw value of every parameter
+ *
+ * Looked up once after the AudioProcessorValueTreeState has been built. Reading a value is a single
+ * atomic load, no string hashing happens on the audio thread.
+ */
+class ParameterHandles
+{
+public:
+    explicit ParameterHandles(juce::AudioProcessorValueTreeState& state);
+
+    float get(ParamId param) const noexcept
+    {
+        return handles[static_cast<size_t>(param)]->load(std::memory_order_relaxed);
+    }
+
+    int getInt(ParamId param) const noexcept
+    {
+        return static_cast<int>(get(param));
+    }
+
+    std::atomic<float>* getRaw(ParamId param) const noexcept
+    {
+        return handles[static_cast<size_t>(param)];
+    }
+
+private:
+    std::array<std::atomic<float>*, numParameters> handles{};
+};
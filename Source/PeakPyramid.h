@@ -0,0 +1,77 @@
+#pragma once
+#include <juce_core/juce_core.h>
+
+#include "ScopeFifo.h"
+
+#include <vector>
+
+
+/**
+ * @brief Rolling min/max history of the scope at several resolutions
+ *
+ * Level 0 holds the peaks exactly as the audio thread delivered them. Every further level merges two
+ * neighbouring peaks of the level below, so it covers the same time span with half as many bins.
+ * Each level is filled as peaks arrive, which makes any zoom level a direct lookup instead of a rescan.
+ */
+class PeakPyramid
+{
+public:
+    static constexpr int maxLevels = 8;
+
+    /**
+     * @param numSamples How many samples of history to keep, rounded up to a power of two number of peaks
+     */
+    explicit PeakPyramid(int numSamples)
+    {
+        const int numPeaks = juce::nextPowerOfTwo(juce::jmax(1, numSamples / ScopeFifo::samplesPerPeak));
+
+        for (int size = numPeaks; size > 0 && static_cast<int>(levels.size()) < maxLevels; size /= 2)
+            levels.push_back({ std::vector<ScopePeak>(static_cast<size_t>(size)) });
+    }
+
+    /**
+     * @brief Appends one bottom level peak and carries it up through the levels.
+     */
+    void push(ScopePeak peak) noexcept
+    {
+        for (auto& level : levels)
+        {
+            level.bins[static_cast<size_t>(level.writePosition)] = peak;
+            level.writePosition = (level.writePosition + 1) & (static_cast<int>(level.bins.size()) - 1);
+
+            if (!level.hasPending)
+            {
+                level.pending = peak;
+                level.hasPending = true;
+                return;
+            }
+
+            peak = ScopePeak::merge(level.pending, peak);
+            level.hasPending = false;
+        }
+    }
+
+    int getNumLevels() const noexcept { return static_cast<int>(levels.size()); }
+    int getNumBins(int level) const noexcept { return static_cast<int>(levels[static_cast<size_t>(level)].bins.size()); }
+    int getNumSamples() const noexcept { return getNumBins(0) * ScopeFifo::samplesPerPeak; }
+
+    /**
+     * @return The bin at index, counted from the oldest bin of that level
+     */
+    ScopePeak getBin(int level, int index) const noexcept
+    {
+        const auto& l = levels[static_cast<size_t>(level)];
+        return l.bins[static_cast<size_t>((l.writePosition + index) & (static_cast<int>(l.bins.size()) - 1))];
+    }
+
+private:
+    struct Level
+    {
+        std::vector<ScopePeak> bins;
+        int writePosition = 0;          // Also the oldest bin
+        ScopePeak pending;              // First half of the next bin of the level above
+        bool hasPending = false;
+    };
+
+    std::vector<Level> levels;
+};
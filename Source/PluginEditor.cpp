@@ -24,20 +24,19 @@ AnimalSynthAudioProcessorEditor::AnimalSynthAudioProcessorEditor (AnimalSynthAud
 
     /// @warning The AudioScope has to be set up BEFORE setting the size of the Plugin window otherwise it crashes! DO NOT MOVE THIS!
     audioScope = std::make_unique<ScaledVisualiserComponent>(1024);
-    audioProcessor.pushAudioToScope = [this](const juce::AudioBuffer<float>& b)
-    {
-        if(audioScope)
-            audioScope->pushBuffer(b);
-    };
+    audioScope->setSource(&audioProcessor.scopeFifo);
     addAndMakeVisible(*audioScope);
 
+    // paint() always covers the whole editor, so nothing behind it has to be redrawn
+    setOpaque(true);
+
     setSize (500, 375);
 
     setLookAndFeel(&customLookAndFeel);
 
     auto& par = audioProcessor.parameters;
 
-    backgroundImage = juce::ImageCache::getFromMemory(BinaryData::background_jpg, BinaryData::background_jpgSize);
+    backgroundImage.setSource(juce::ImageCache::getFromMemory(BinaryData::background_jpg, BinaryData::background_jpgSize));
 
     sineImage = juce::ImageCache::getFromMemory(BinaryData::wolfPanel_jpg, BinaryData::wolfPanel_jpgSize);
     sawImage = juce::ImageCache::getFromMemory(BinaryData::bearPanel_jpg, BinaryData::bearPanel_jpgSize);
@@ -52,7 +51,7 @@ AnimalSynthAudioProcessorEditor::AnimalSynthAudioProcessorEditor (AnimalSynthAud
     addAndMakeVisible(waveformSelector);
 
     waveformAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
-        audioProcessor.parameters, "waveform", waveformSelector);
+        audioProcessor.parameters, getParameterID(ParamId::waveform), waveformSelector);
 
     auto styleKnob = [](juce::Slider& s)
         {
@@ -84,10 +83,10 @@ AnimalSynthAudioProcessorEditor::AnimalSynthAudioProcessorEditor (AnimalSynthAud
     releaseLabel.setJustificationType(juce::Justification::centred);
     addAndMakeVisible(releaseSlider);
 
-    attackAttachment = std::make_unique<SliderAttachment>(par, "attack", attackSlider);
-    decayAttachment = std::make_unique<SliderAttachment>(par, "decay", decaySlider);
-    sustainAttachment = std::make_unique<SliderAttachment>(par, "sustain", sustainSlider);
-    releaseAttachment = std::make_unique<SliderAttachment>(par, "release", releaseSlider);
+    attackAttachment = std::make_unique<SliderAttachment>(par, getParameterID(ParamId::attack), attackSlider);
+    decayAttachment = std::make_unique<SliderAttachment>(par, getParameterID(ParamId::decay), decaySlider);
+    sustainAttachment = std::make_unique<SliderAttachment>(par, getParameterID(ParamId::sustain), sustainSlider);
+    releaseAttachment = std::make_unique<SliderAttachment>(par, getParameterID(ParamId::release), releaseSlider);
 
     sineFXPanel.setImage(sineImage);
     addAndMakeVisible(sineFXPanel);
@@ -101,7 +100,8 @@ AnimalSynthAudioProcessorEditor::AnimalSynthAudioProcessorEditor (AnimalSynthAud
     triangleFXPanel.setImage(triangleImage);
     addAndMakeVisible(triangleFXPanel);
 
-    wildlifeCam.setNewAnimal(0);
+    wildlifeCam.setNewAnimal(static_cast<int>(*par.getRawParameterValue(getParameterID(ParamId::waveform))));
+    wildlifeCam.setFeedbackSource(&audioProcessor.visualFeedback);
     logoPanel.setNewAnimal(99);
 
     wildlifeCam.setInterceptsMouseClicks(false, false);
@@ -113,6 +113,10 @@ AnimalSynthAudioProcessorEditor::AnimalSynthAudioProcessorEditor (AnimalSynthAud
     logoPanel.setText("PolyMal");
     addAndMakeVisible(logoPanel);
 
+    repaintScheduler.addClient(audioScope.get());
+    repaintScheduler.addClient(&wildlifeCam);
+    repaintScheduler.addClient(&logoPanel);
+
 #pragma region Slider Text Overrides
 
     // Saw Shape text display — show "Off" if drive is OFF
@@ -138,21 +142,24 @@ AnimalSynthAudioProcessorEditor::AnimalSynthAudioProcessorEditor (AnimalSynthAud
 
 AnimalSynthAudioProcessorEditor::~AnimalSynthAudioProcessorEditor()
 {
-    audioProcessor.pushAudioToScope = nullptr;
+    audioScope->setSource(nullptr);
 }
 
 //==============================================================================
 void AnimalSynthAudioProcessorEditor::paint (juce::Graphics& g)
 {
     // (Our component is opaque, so we must completely fill the background with a solid colour)
+    g.fillAll(juce::Colours::black); // Fallback color, also behind the edges of the image
+
     if (backgroundImage.isValid())
-        g.drawImage(backgroundImage, getLocalBounds().toFloat());
-    else
-        g.fillAll(juce::Colours::black); // Fallback color
+        backgroundImage.draw(g, *this, getLocalBounds());
 }
 
 void AnimalSynthAudioProcessorEditor::resized()
 {
+    // Resample the static background once per size instead of on every paint
+    backgroundImage.update(getLocalBounds(), juce::Component::getApproximateScaleFactorForComponent(this));
+
     auto bounds = getLocalBounds().reduced(10);
 
     // Top bar for waveform selector and animation preview
@@ -233,7 +240,7 @@ void AnimalSynthAudioProcessorEditor::resized()
 
     sawCombLabel.setBounds(xPos + titleLabelOffset, titleLabelYPos, 60, 60);
     formantLabel.setBounds(xPos + titleLabelOffset * 5, titleLabelYPos, 60, 60);
-    waveshapeLabel.setBounds(xPos + titleLabelOffset * 9, titleLabelYPos, 60, 60);
+    sawCurveSelector.setBounds(xPos + (sliderPadding + fxSliderSize) * 4, 2, fxSliderSize * 2 + sliderPadding, 16);
 
     // === Square Sliders ===
     squarePunchAmountSlider.setBounds(xPos, yPos, fxSliderSize, fxSliderSize);
@@ -308,7 +315,7 @@ void AnimalSynthAudioProcessorEditor::setupEffectPanels()
     sineFXPanel.addAndMakeVisible(vibratoRateLabel);
 
     vibratoRateAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        audioProcessor.parameters, "vibratoRate", vibratoRateSlider);
+        audioProcessor.parameters, getParameterID(ParamId::vibratoRate), vibratoRateSlider);
 
     // Vibrato Depth
     vibratoDepthSlider.setSliderStyle(juce::Slider::Rotary);
@@ -320,7 +327,7 @@ void AnimalSynthAudioProcessorEditor::setupEffectPanels()
     sineFXPanel.addAndMakeVisible(vibratoDepthLabel);
 
     vibratoDepthAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        audioProcessor.parameters, "vibratoDepth", vibratoDepthSlider);
+        audioProcessor.parameters, getParameterID(ParamId::vibratoDepth), vibratoDepthSlider);
 
 
     // === Flutter ===
@@ -337,7 +344,7 @@ void AnimalSynthAudioProcessorEditor::setupEffectPanels()
     sineFXPanel.addAndMakeVisible(chorusDepthLabel);
 
     chorusDepthAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        audioProcessor.parameters, "sineChorusDepth", chorusDepthSlider);
+        audioProcessor.parameters, getParameterID(ParamId::sineChorusDepth), chorusDepthSlider);
 
     // Flutter Rate
     chorusRateSlider.setSliderStyle(juce::Slider::Rotary);
@@ -349,7 +356,7 @@ void AnimalSynthAudioProcessorEditor::setupEffectPanels()
     sineFXPanel.addAndMakeVisible(chorusRateLabel);
 
     chorusRateAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        audioProcessor.parameters, "sineChorusRate", chorusRateSlider);
+        audioProcessor.parameters, getParameterID(ParamId::sineChorusRate), chorusRateSlider);
 
     // === Tremolo ===
     tremoloLabel.setText("Tremolo", juce::dontSendNotification);
@@ -365,7 +372,7 @@ void AnimalSynthAudioProcessorEditor::setupEffectPanels()
     sineFXPanel.addAndMakeVisible(tremoloDepthLabel);
 
     tremoloDepthAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        audioProcessor.parameters, "tremoloDepth", tremoloDepthSlider);
+        audioProcessor.parameters, getParameterID(ParamId::tremoloDepth), tremoloDepthSlider);
 
     //Tremolo Rate
     tremoloRateSlider.setSliderStyle(juce::Slider::Rotary);
@@ -377,7 +384,7 @@ void AnimalSynthAudioProcessorEditor::setupEffectPanels()
     sineFXPanel.addAndMakeVisible(tremoloRateLabel);
 
     tremoloRateAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        audioProcessor.parameters, "tremoloRate", tremoloRateSlider);
+        audioProcessor.parameters, getParameterID(ParamId::tremoloRate), tremoloRateSlider);
 
     // ===== Saw Panel =====
     // === Comb ===
@@ -394,7 +401,7 @@ void AnimalSynthAudioProcessorEditor::setupEffectPanels()
     sawFXPanel.addAndMakeVisible(sawCombTimeLabel);
 
     sawCombTimeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        audioProcessor.parameters, "sawCombTime", sawCombTimeSlider);
+        audioProcessor.parameters, getParameterID(ParamId::sawCombTime), sawCombTimeSlider);
 
     // Comb Feedback
     sawCombFeedbackSlider.setSliderStyle(juce::Slider::Rotary);
@@ -406,7 +413,7 @@ void AnimalSynthAudioProcessorEditor::setupEffectPanels()
     sawFXPanel.addAndMakeVisible(sawCombFeedbackLabel);
 
     sawCombFeedbackAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        audioProcessor.parameters, "sawCombFeedback", sawCombFeedbackSlider);
+        audioProcessor.parameters, getParameterID(ParamId::sawCombFeedback), sawCombFeedbackSlider);
 
     // === Formant ===
     formantLabel.setText("Formant", juce::dontSendNotification);
@@ -431,15 +438,18 @@ void AnimalSynthAudioProcessorEditor::setupEffectPanels()
     sawFXPanel.addAndMakeVisible(formantResLabel);
 
     formantFreqAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        audioProcessor.parameters, "formantFreq", formantFreqSlider);
+        audioProcessor.parameters, getParameterID(ParamId::formantFreq), formantFreqSlider);
 
     formantResAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        audioProcessor.parameters, "formantResonance", formantResSlider);
+        audioProcessor.parameters, getParameterID(ParamId::formantResonance), formantResSlider);
 
     // === Waveshape ===
-    waveshapeLabel.setText("Waveshape", juce::dontSendNotification);
-    waveshapeLabel.setJustificationType(juce::Justification::centred);
-    sawFXPanel.addAndMakeVisible(waveshapeLabel);
+    // Item IDs are the choice index + 1, as the ComboBoxAttachment expects
+    sawCurveSelector.addItemList(juce::StringArray::fromTokens(getParameterSpec(ParamId::sawCurve).choices, "|", {}), 1);
+    sawFXPanel.addAndMakeVisible(sawCurveSelector);
+
+    sawCurveAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        audioProcessor.parameters, getParameterID(ParamId::sawCurve), sawCurveSelector);
 
     // Saw Drive
     sawDriveSlider.setSliderStyle(juce::Slider::Rotary);
@@ -451,7 +461,7 @@ void AnimalSynthAudioProcessorEditor::setupEffectPanels()
     sawFXPanel.addAndMakeVisible(sawDriveLabel);
 
     sawDriveAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-            audioProcessor.parameters, "sawDrive", sawDriveSlider);
+            audioProcessor.parameters, getParameterID(ParamId::sawDrive), sawDriveSlider);
 
     // Saw Shape
     sawShapeSlider.setSliderStyle(juce::Slider::Rotary);
@@ -463,7 +473,7 @@ void AnimalSynthAudioProcessorEditor::setupEffectPanels()
     sawFXPanel.addAndMakeVisible(sawShapeLabel);
 
     sawShapeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        audioProcessor.parameters, "sawShape", sawShapeSlider);
+        audioProcessor.parameters, getParameterID(ParamId::sawShape), sawShapeSlider);
 
 
     // ===== Square Panel =====
@@ -483,7 +493,7 @@ void AnimalSynthAudioProcessorEditor::setupEffectPanels()
     squareFXPanel.addAndMakeVisible(squarePunchAmountLabel);
 
     squarePunchAmountAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        audioProcessor.parameters, "squarePunchAmount", squarePunchAmountSlider);
+        audioProcessor.parameters, getParameterID(ParamId::squarePunchAmount), squarePunchAmountSlider);
 
     // Punch Decay Slider
     squarePunchDecaySlider.setSliderStyle(juce::Slider::Rotary);
@@ -495,7 +505,7 @@ void AnimalSynthAudioProcessorEditor::setupEffectPanels()
     squareFXPanel.addAndMakeVisible(squarePunchDecayLabel);
 
     squarePunchDecayAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        audioProcessor.parameters, "squarePunchDecay", squarePunchDecaySlider);
+        audioProcessor.parameters, getParameterID(ParamId::squarePunchDecay), squarePunchDecaySlider);
 
     // === Bitcrush ===
     bitcrushLabel.setText("Bitcrush", juce::dontSendNotification);
@@ -512,7 +522,7 @@ void AnimalSynthAudioProcessorEditor::setupEffectPanels()
     squareFXPanel.addAndMakeVisible(squareBitcrushRateLabel);
 
     squareBitcrushRateAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        audioProcessor.parameters, "squareBitcrushRate", squareBitcrushRateSlider);
+        audioProcessor.parameters, getParameterID(ParamId::squareBitcrushRate), squareBitcrushRateSlider);
 
     // Depth (Bit Depth Reduction)
     squareBitcrushDepthSlider.setSliderStyle(juce::Slider::Rotary);
@@ -524,7 +534,7 @@ void AnimalSynthAudioProcessorEditor::setupEffectPanels()
     squareFXPanel.addAndMakeVisible(squareBitcrushDepthLabel);
 
     squareBitcrushDepthAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        audioProcessor.parameters, "squareBitcrushDepth", squareBitcrushDepthSlider);
+        audioProcessor.parameters, getParameterID(ParamId::squareBitcrushDepth), squareBitcrushDepthSlider);
 
     // === Bark Filter ===
     barkFilterLabel.setText("Bark Filter", juce::dontSendNotification);
@@ -540,7 +550,7 @@ void AnimalSynthAudioProcessorEditor::setupEffectPanels()
     squareFXPanel.addAndMakeVisible(barkFilterFreqLabel);
 
     barkFilterFreqAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        audioProcessor.parameters, "barkFilterFreq", barkFilterFreqSlider);
+        audioProcessor.parameters, getParameterID(ParamId::barkFilterFreq), barkFilterFreqSlider);
 
     barkFilterResSlider.setSliderStyle(juce::Slider::Rotary);
     barkFilterResSlider.setTextBoxStyle(juce::Slider::TextBoxBelow, false, 60, 20);
@@ -551,7 +561,7 @@ void AnimalSynthAudioProcessorEditor::setupEffectPanels()
     squareFXPanel.addAndMakeVisible(barkFilterResLabel);
 
     barkFilterResAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        audioProcessor.parameters, "barkFilterResonance", barkFilterResSlider);
+        audioProcessor.parameters, getParameterID(ParamId::barkFilterResonance), barkFilterResSlider);
 
 
     // ===== Triangle Panel =====
@@ -571,7 +581,7 @@ void AnimalSynthAudioProcessorEditor::setupEffectPanels()
     triangleFXPanel.addAndMakeVisible(triGlideTimeLabel);
 
     triGlideTimeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        audioProcessor.parameters, "triGlideTime", triGlideTimeSlider);
+        audioProcessor.parameters, getParameterID(ParamId::triGlideTime), triGlideTimeSlider);
 
     // Glide Depth
     triGlideDepthSlider.setSliderStyle(juce::Slider::Rotary);
@@ -584,7 +594,7 @@ void AnimalSynthAudioProcessorEditor::setupEffectPanels()
     triGlideDepthSlider.setNumDecimalPlacesToDisplay(0);
 
     triGlideDepthAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        audioProcessor.parameters, "triGlideDepth", triGlideDepthSlider);
+        audioProcessor.parameters, getParameterID(ParamId::triGlideDepth), triGlideDepthSlider);
 
     // === Chirp ===
     chirpLabel.setText("Chirp", juce::dontSendNotification);
@@ -601,7 +611,7 @@ void AnimalSynthAudioProcessorEditor::setupEffectPanels()
     triangleFXPanel.addAndMakeVisible(triChirpRateLabel);
 
     triChirpRateAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        audioProcessor.parameters, "triChirpRate", triChirpRateSlider);
+        audioProcessor.parameters, getParameterID(ParamId::triChirpRate), triChirpRateSlider);
 
     // Chirp Depth
     triChirpDepthSlider.setSliderStyle(juce::Slider::Rotary);
@@ -613,7 +623,7 @@ void AnimalSynthAudioProcessorEditor::setupEffectPanels()
     triangleFXPanel.addAndMakeVisible(triChirpDepthLabel);
 
     triChirpDepthAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        audioProcessor.parameters, "triChirpDepth", triChirpDepthSlider);
+        audioProcessor.parameters, getParameterID(ParamId::triChirpDepth), triChirpDepthSlider);
 
     // === Echo ===
     echoLabel.setText("Echo", juce::dontSendNotification);
@@ -630,7 +640,7 @@ void AnimalSynthAudioProcessorEditor::setupEffectPanels()
     triangleFXPanel.addAndMakeVisible(triEchoTimeLabel);
 
     triEchoTimeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        audioProcessor.parameters, "triEchoTime", triEchoTimeSlider);
+        audioProcessor.parameters, getParameterID(ParamId::triEchoTime), triEchoTimeSlider);
 
     // Echo Mix
     triEchoMixSlider.setSliderStyle(juce::Slider::Rotary);
@@ -642,7 +652,7 @@ void AnimalSynthAudioProcessorEditor::setupEffectPanels()
     triangleFXPanel.addAndMakeVisible(triEchoMixLabel);
 
     triEchoMixAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        audioProcessor.parameters, "triEchoMix", triEchoMixSlider);
+        audioProcessor.parameters, getParameterID(ParamId::triEchoMix), triEchoMixSlider);
 
 
     updateEffectUI();
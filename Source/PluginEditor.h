@@ -15,6 +15,8 @@
 #include "FXPanel.h"
 #include "CustomLookAndFeel.h"
 #include "AnimationDisplayComponent.h"
+#include "PrescaledImage.h"
+#include "RepaintScheduler.h"
 
 //==============================================================================
 /**
@@ -46,7 +48,7 @@ private:
     CustomLookAndFeel customLookAndFeel;
 
     /// ===== Panels and Assets =====
-    juce::Image backgroundImage;
+    PrescaledImage backgroundImage;
     juce::Image sineImage, sawImage, squareImage, triangleImage;
     FXPanel sineFXPanel, sawFXPanel, squareFXPanel, triangleFXPanel;
 
@@ -89,9 +91,12 @@ private:
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> formantFreqAttachment, formantResAttachment;
 
     juce::Slider sawDriveSlider, sawShapeSlider;
-    juce::Label waveshapeLabel, sawDriveLabel, sawShapeLabel;
+    juce::Label sawDriveLabel, sawShapeLabel;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> sawDriveAttachment, sawShapeAttachment;
 
+    juce::ComboBox sawCurveSelector;    // Takes the place of the "Waveshape" title
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> sawCurveAttachment;
+
 
 
 
@@ -124,6 +129,9 @@ private:
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> triEchoTimeAttachment, triEchoMixAttachment;
 #pragma endregion
 
+    /// Declared last so it is destroyed before any of the components it refreshes
+    RepaintScheduler repaintScheduler{ *this, [this] { return audioProcessor.visualFeedback.envelopeLevel.load(std::memory_order_relaxed) > 0.0f; } };
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AnimalSynthAudioProcessorEditor)
 };
 
@@ -11,6 +11,13 @@
 #include <juce_dsp/juce_dsp.h>
 #include <juce_core/juce_core.h>
 
+#include "AnimalSynthesiser.h"
+#include "Chorus.h"
+#include "BlockScheduler.h"
+#include "ParameterTable.h"
+#include "RealtimeSafety.h"
+#include "ScopeFifo.h"
+#include "VisualFeedback.h"
 
 
 //==============================================================================
@@ -32,6 +39,8 @@ public:
    #endif
 
     void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlock (juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+    bool supportsDoublePrecisionProcessing() const override { return true; }
 
     //==============================================================================
     juce::AudioProcessorEditor* createEditor() override;
@@ -56,86 +65,48 @@ public:
     void getStateInformation (juce::MemoryBlock& destData) override;
     void setStateInformation (const void* data, int sizeInBytes) override;
 
-    std::function<void(const juce::AudioBuffer<float>&)> pushAudioToScope;
+    bool loadPreset(const juce::XmlElement& xml);
 
     juce::AudioProcessorValueTreeState parameters;
 
-    juce::ADSR adsr;
-    juce::ADSR::Parameters adsrParams;
+    /// Envelope and waveform state for the UI. Written by the audio thread only, never requires an editor.
+    VisualFeedback visualFeedback;
 
+    /// Output samples for the scope. Pushed by the audio thread every block, drained by the editor.
+    ScopeFifo scopeFifo;
 
-private:
-    //=============================================================================
-    enum class WaveformType
-    {
-        Sine,
-        Saw,
-        Square,
-        Triangle
-    };
-
-    //WaveformType waveformType = WaveformType::Square;
-    using WaveformFunction = float(*)(double);
-    WaveformFunction currentWaveformFunction = nullptr;
-
-    double currentSampleRate = 44100.0;
-    double phase = 0.0;
-    double phaseIncrement = 0.0;
-    int midiNote = -1;
-    bool noteIsOn = false;
-
-    void processSineWave(juce::AudioBuffer<float>&, juce::MidiBuffer&);
-    void processSawWave(juce::AudioBuffer<float>&, juce::MidiBuffer&);
-    void processSquareWave(juce::AudioBuffer<float>&, juce::MidiBuffer&);
-    void processTriangleWave(juce::AudioBuffer<float>&, juce::MidiBuffer&);
-
-
-    /// === Sine Filter and FX ===
-    juce::dsp::StateVariableTPTFilter<float> sineFilter;
-    float sinefilterEnvelope = 0.0f;
-    float sineFilterEnvIncrement = 0.0f;
-
-    double vibratoPhase = 0.0;
-    double vibratoRate = 5.0;
-    double vibratoDepth = 0.005;
-
-    juce::dsp::Chorus<float> sineChorus;
+    void setVoiceCount(int numberOfVoices);
+    int getVoiceCount() const noexcept { return voiceCount; }
 
-    float tremoloPhase = 0.0f;
+    bool scheduleParameterChange(int samplePosition, ParamId param, float value) noexcept;
 
-    /// === Saw Filter and FX ===
-    // Comb filter
-    juce::AudioBuffer<float> sawCombBuffer;
-    int sawCombWritePosition = 0;
+    void setRenderThreads(int numberOfThreads);
+    int getNumRenderThreads() const noexcept { return synth.getNumWorkers(); }
+    float getRenderThreadUtilisation(int thread) const noexcept { return synth.getWorkerUtilisation(thread); }
 
 
-    juce::dsp::StateVariableTPTFilter<float> formantFilter;
-
-
-    /// === Square Filter and FX ===
-    float squarePunchLevel = 0.0f;
-    float squarePunchDecayRate = 0.0f;
-
-    float lastBitcrushedSample = 0.0f;
-    int bitcrushCounter = 0;
-
-    juce::dsp::StateVariableTPTFilter<float> barkFilter;
-    float barkFilterEnvelope = 0.0f;
-    float barkFilterDecayRate = 0.0f;
-
-    /// === Triangle Filter and FX ===
-    double glideStartFreq = 0.0f;
-    double glideTargetFreq = 0.0f;
-    double glideCurrentFreq = 0.0f;
-    double glideStep = 0.0f;
-    int glideSamplesLeft = 0;
-
-    float chirpPhase = 0.0f;
-    float chirpRate = 0.0f;
-    float chirpDepth = 0.0f;
-
-    juce::AudioBuffer<float> echoBuffer;
-    int echoWritePosition = 0;
+private:
+    //=============================================================================
+    template <typename SampleType>
+    void processSamples(juce::AudioBuffer<SampleType>& buffer, juce::MidiBuffer& midiMessages);
+
+    void updateVoiceParameters(int numSamples);
+    void copyVoiceParameters();
+
+    const ParameterHandles params;
+    ParameterSmoother smoother;
+    BlockScheduler scheduler;
+
+    AnimalSynthesiser synth;
+    VoiceParameters voiceParams;
+    int voiceCount = VoicePool::defaultVoices;
+    int renderThreads = 0;
+
+    /// === Sine FX ===
+    // The chorus runs on the summed voices, the rest of the FX live in the voices themselves.
+    // One per precision, only the one matching the host's processing precision is used
+    Chorus<float> sineChorus;
+    Chorus<double> sineChorusDouble;
 
 
     //==============================================================================
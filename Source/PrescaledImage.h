@@ -0,0 +1,72 @@
+#pragma once
+#include <juce_gui_basics/juce_gui_basics.h>
+#include <juce_graphics/juce_graphics.h>
+
+
+/**
+ * @brief A static background image that keeps a copy resampled to the size it is drawn at
+ *
+ * The copy has the component's physical pixel size, so painting it is a plain blit instead of a full
+ * resampling pass. It is rebuilt only when the size or the display scale changes.
+ */
+class PrescaledImage
+{
+public:
+    explicit PrescaledImage(juce::RectanglePlacement placementToUse = juce::RectanglePlacement::centred)
+        : placement(placementToUse)
+    {
+    }
+
+    void setSource(juce::Image newSource)
+    {
+        source = std::move(newSource);
+        scaled = {};
+    }
+
+    bool isValid() const noexcept { return source.isValid(); }
+
+    /**
+     * @brief Resamples the source for the given area. Does nothing if the copy already matches.
+     *
+     * @param area Where the image goes, in the component's coordinates
+     * @param scale Physical pixels per logical pixel of the component
+     */
+    void update(juce::Rectangle<int> area, float scale)
+    {
+        if (!source.isValid() || area.isEmpty())
+            return;
+
+        const auto target = placement.appliedTo(source.getBounds().toFloat(), area.toFloat());
+
+        if (scaled.isValid() && target == targetArea && scale == targetScale)
+            return;
+
+        targetArea = target;
+        targetScale = scale;
+        scaled = source.rescaled(juce::jmax(1, juce::roundToInt(target.getWidth() * scale)),
+                                 juce::jmax(1, juce::roundToInt(target.getHeight() * scale)),
+                                 juce::Graphics::highResamplingQuality);
+    }
+
+    /**
+     * @brief Draws the copy, first bringing it up to date if the component moved to a display with another scale.
+     */
+    void draw(juce::Graphics& g, const juce::Component& component, juce::Rectangle<int> area)
+    {
+        update(area, juce::Component::getApproximateScaleFactorForComponent(&component));
+
+        if (!scaled.isValid())
+            return;
+
+        // The copy already has the pixel size of its target, so there is nothing left to filter
+        const juce::Graphics::ScopedSaveState state(g);
+        g.setImageResamplingQuality(juce::Graphics::lowResamplingQuality);
+        g.drawImage(scaled, targetArea);
+    }
+
+private:
+    juce::RectanglePlacement placement;
+    juce::Image source, scaled;
+    juce::Rectangle<float> targetArea;
+    float targetScale = 0.0f;
+};
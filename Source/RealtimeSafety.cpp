@@ -0,0 +1,371 @@
+#include "RealtimeSafety.h"
+
+#if ANIMALSYNTH_RT_CHECKS
+
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <set>
+
+#if JUCE_LINUX
+ #include <dlfcn.h>
+ #include <pthread.h>
+ #include <time.h>
+ #include <unistd.h>
+#endif
+
+
+namespace
+{
+    // Plain thread_locals with constant initialisation, so touching them never allocates
+    thread_local int audioDepth = 0;
+    thread_local int allowDepth = 0;
+    thread_local int allowLocksDepth = 0;
+    thread_local bool reporting = false;
+
+    std::atomic<int> violations{ 0 };
+}
+
+RealtimeSafety::ScopedAudioThread::ScopedAudioThread() noexcept { ++audioDepth; }
+RealtimeSafety::ScopedAudioThread::~ScopedAudioThread() noexcept { --audioDepth; }
+
+RealtimeSafety::ScopedAllow::ScopedAllow() noexcept { ++allowDepth; }
+RealtimeSafety::ScopedAllow::~ScopedAllow() noexcept { --allowDepth; }
+
+RealtimeSafety::ScopedAllowLocks::ScopedAllowLocks() noexcept { ++allowLocksDepth; }
+RealtimeSafety::ScopedAllowLocks::~ScopedAllowLocks() noexcept { --allowLocksDepth; }
+
+bool RealtimeSafety::isAudioThread() noexcept
+{
+    return audioDepth > 0;
+}
+
+/**
+ * @brief Counts the violation and prints it with a stack trace, once per distinct call stack.
+ *
+ * Reporting allocates and locks itself, so the checks are off for this thread while it runs.
+ */
+void RealtimeSafety::check(const char* what) noexcept
+{
+    if (audioDepth == 0 || allowDepth > 0 || reporting)
+        return;
+
+    reporting = true;
+    ++violations;
+
+    static std::mutex reportLock;
+    static std::set<juce::String> reported;
+
+    {
+        // Scoped, so the trace is freed while the checks are still off
+        const auto backtrace = juce::SystemStats::getStackBacktrace();
+        const std::lock_guard<std::mutex> lock(reportLock);
+
+        if (reported.insert(backtrace).second)
+            std::fprintf(stderr, "Real-time violation on the audio thread: %s\n%s\n", what, backtrace.toRawUTF8());
+    }
+
+    reporting = false;
+}
+
+int RealtimeSafety::getNumViolations() noexcept
+{
+    return violations.load();
+}
+
+
+//==============================================================================
+// Every allocation and deallocation in the process goes through these
+
+namespace
+{
+   #if JUCE_LINUX
+    // The C allocator is interposed below, so operator new/delete go straight to the real one and report once
+    void* systemMalloc(std::size_t size) noexcept;
+    int systemMemalign(void** memory, std::size_t alignment, std::size_t size) noexcept;
+    void systemFree(void* memory) noexcept;
+   #else
+    void* systemMalloc(std::size_t size) noexcept { return std::malloc(size); }
+    void systemFree(void* memory) noexcept { std::free(memory); }
+   #endif
+
+    void* allocate(std::size_t size, std::size_t alignment = 0) noexcept
+    {
+        RealtimeSafety::check("operator new");
+
+        size = size == 0 ? 1 : size;
+
+        if (alignment <= alignof(std::max_align_t))
+            return systemMalloc(size);
+
+       #if JUCE_WINDOWS
+        return _aligned_malloc(size, alignment);
+       #elif JUCE_LINUX
+        void* memory = nullptr;
+        return systemMemalign(&memory, alignment, size) == 0 ? memory : nullptr;
+       #else
+        void* memory = nullptr;
+        return posix_memalign(&memory, alignment, size) == 0 ? memory : nullptr;
+       #endif
+    }
+
+    void release(void* memory, std::size_t alignment = 0) noexcept
+    {
+        if (memory == nullptr)
+            return;
+
+        RealtimeSafety::check("operator delete");
+
+       #if JUCE_WINDOWS
+        if (alignment > alignof(std::max_align_t))
+            return _aligned_free(memory);
+       #else
+        juce::ignoreUnused(alignment);
+       #endif
+
+        systemFree(memory);
+    }
+
+    void* allocateOrThrow(std::size_t size, std::size_t alignment = 0)
+    {
+        if (void* memory = allocate(size, alignment))
+            return memory;
+
+        throw std::bad_alloc();
+    }
+}
+
+void* operator new(std::size_t size) { return allocateOrThrow(size); }
+void* operator new[](std::size_t size) { return allocateOrThrow(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return allocate(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return allocate(size); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return allocateOrThrow(size, static_cast<std::size_t>(alignment)); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return allocateOrThrow(size, static_cast<std::size_t>(alignment)); }
+
+void operator delete(void* memory) noexcept { release(memory); }
+void operator delete[](void* memory) noexcept { release(memory); }
+void operator delete(void* memory, std::size_t) noexcept { release(memory); }
+void operator delete[](void* memory, std::size_t) noexcept { release(memory); }
+void operator delete(void* memory, std::align_val_t alignment) noexcept { release(memory, static_cast<std::size_t>(alignment)); }
+void operator delete[](void* memory, std::align_val_t alignment) noexcept { release(memory, static_cast<std::size_t>(alignment)); }
+void operator delete(void* memory, std::size_t, std::align_val_t alignment) noexcept { release(memory, static_cast<std::size_t>(alignment)); }
+void operator delete[](void* memory, std::size_t, std::align_val_t alignment) noexcept { release(memory, static_cast<std::size_t>(alignment)); }
+
+
+//==============================================================================
+// Locks, waits, sleeps and blocking I/O. The executable's definitions win the symbol lookup,
+// the real functions are found with RTLD_NEXT.
+
+#if JUCE_LINUX
+namespace
+{
+    /**
+     * @brief Looks the real function up on first use. No function-local static, since its guard could lock.
+     */
+    template <typename Function>
+    Function real(std::atomic<Function>& cache, const char* name) noexcept
+    {
+        auto function = cache.load(std::memory_order_relaxed);
+
+        if (function == nullptr)
+        {
+            function = reinterpret_cast<Function>(dlsym(RTLD_NEXT, name));
+            cache.store(function, std::memory_order_relaxed);
+        }
+
+        return function;
+    }
+
+    std::atomic<int (*)(pthread_mutex_t*)> realMutexLock{ nullptr };
+    std::atomic<int (*)(pthread_cond_t*, pthread_mutex_t*)> realCondWait{ nullptr };
+    std::atomic<int (*)(pthread_cond_t*, pthread_mutex_t*, const timespec*)> realCondTimedWait{ nullptr };
+    std::atomic<int (*)(const timespec*, timespec*)> realNanosleep{ nullptr };
+    std::atomic<int (*)(useconds_t)> realUsleep{ nullptr };
+    std::atomic<ssize_t (*)(int, void*, size_t)> realRead{ nullptr };
+    std::atomic<ssize_t (*)(int, const void*, size_t)> realWrite{ nullptr };
+}
+
+extern "C"
+{
+    int pthread_mutex_lock(pthread_mutex_t* mutex)
+    {
+        if (allowLocksDepth == 0)
+            RealtimeSafety::check("pthread_mutex_lock");
+
+        return real(realMutexLock, "pthread_mutex_lock")(mutex);
+    }
+
+    int pthread_cond_wait(pthread_cond_t* condition, pthread_mutex_t* mutex)
+    {
+        RealtimeSafety::check("pthread_cond_wait");
+        return real(realCondWait, "pthread_cond_wait")(condition, mutex);
+    }
+
+    int pthread_cond_timedwait(pthread_cond_t* condition, pthread_mutex_t* mutex, const timespec* time)
+    {
+        RealtimeSafety::check("pthread_cond_timedwait");
+        return real(realCondTimedWait, "pthread_cond_timedwait")(condition, mutex, time);
+    }
+
+    int nanosleep(const timespec* duration, timespec* remaining)
+    {
+        RealtimeSafety::check("nanosleep");
+        return real(realNanosleep, "nanosleep")(duration, remaining);
+    }
+
+    int usleep(useconds_t microseconds)
+    {
+        RealtimeSafety::check("usleep");
+        return real(realUsleep, "usleep")(microseconds);
+    }
+
+    ssize_t read(int file, void* buffer, size_t size)
+    {
+        RealtimeSafety::check("read");
+        return real(realRead, "read")(file, buffer, size);
+    }
+
+    ssize_t write(int file, const void* buffer, size_t size)
+    {
+        RealtimeSafety::check("write");
+        return real(realWrite, "write")(file, buffer, size);
+    }
+}
+
+
+//==============================================================================
+// The C allocator. dlsym allocates itself while it looks the real functions up, so whatever
+// is asked for during the lookup comes from a static buffer that is never freed.
+
+namespace
+{
+    alignas(std::max_align_t) char bootstrapMemory[8192];
+    std::atomic<std::size_t> bootstrapUsed{ 0 };
+    std::atomic<bool> resolvingAllocator{ false };
+
+    std::atomic<void* (*)(std::size_t)> realMalloc{ nullptr };
+    std::atomic<void* (*)(std::size_t, std::size_t)> realCalloc{ nullptr };
+    std::atomic<void* (*)(void*, std::size_t)> realRealloc{ nullptr };
+    std::atomic<int (*)(void**, std::size_t, std::size_t)> realMemalign{ nullptr };
+    std::atomic<void (*)(void*)> realFree{ nullptr };
+
+    bool isBootstrapMemory(const void* memory) noexcept
+    {
+        return memory >= bootstrapMemory && memory < bootstrapMemory + sizeof(bootstrapMemory);
+    }
+
+    void* bootstrapAllocate(std::size_t size) noexcept
+    {
+        const std::size_t rounded = (size + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+        const std::size_t offset = bootstrapUsed.fetch_add(rounded);
+
+        return offset + rounded <= sizeof(bootstrapMemory) ? bootstrapMemory + offset : nullptr;
+    }
+
+    /**
+     * @return The real allocator function, or nullptr while dlsym is still looking it up
+     */
+    template <typename Function>
+    Function realAllocator(std::atomic<Function>& cache, const char* name) noexcept
+    {
+        auto function = cache.load(std::memory_order_relaxed);
+
+        if (function != nullptr || resolvingAllocator.exchange(true))
+            return function;
+
+        function = reinterpret_cast<Function>(dlsym(RTLD_NEXT, name));
+        cache.store(function, std::memory_order_relaxed);
+        resolvingAllocator.store(false);
+        return function;
+    }
+
+    void* systemMalloc(std::size_t size) noexcept
+    {
+        if (auto function = realAllocator(realMalloc, "malloc"))
+            return function(size);
+
+        return bootstrapAllocate(size);
+    }
+
+    int systemMemalign(void** memory, std::size_t alignment, std::size_t size) noexcept
+    {
+        if (auto function = realAllocator(realMemalign, "posix_memalign"))
+            return function(memory, alignment, size);
+
+        return ENOMEM;
+    }
+
+    void systemFree(void* memory) noexcept
+    {
+        if (isBootstrapMemory(memory))
+            return;
+
+        if (auto function = realAllocator(realFree, "free"))
+            function(memory);
+    }
+}
+
+extern "C"
+{
+    void* malloc(size_t size)
+    {
+        RealtimeSafety::check("malloc");
+        return systemMalloc(size);
+    }
+
+    void* calloc(size_t count, size_t size)
+    {
+        RealtimeSafety::check("calloc");
+
+        if (auto function = realAllocator(realCalloc, "calloc"))
+            return function(count, size);
+
+        // Static memory is zeroed already
+        return size == 0 || count <= SIZE_MAX / size ? bootstrapAllocate(count * size) : nullptr;
+    }
+
+    void* realloc(void* memory, size_t size)
+    {
+        RealtimeSafety::check("realloc");
+
+        if (isBootstrapMemory(memory))
+        {
+            // The old size is unknown, so copy as much as the buffer holds behind it
+            void* moved = systemMalloc(size);
+
+            if (moved != nullptr)
+                std::memcpy(moved, memory, juce::jmin(size, static_cast<size_t>(bootstrapMemory + sizeof(bootstrapMemory) - static_cast<char*>(memory))));
+
+            return moved;
+        }
+
+        if (auto function = realAllocator(realRealloc, "realloc"))
+            return function(memory, size);
+
+        return nullptr;
+    }
+
+    int posix_memalign(void** memory, size_t alignment, size_t size)
+    {
+        RealtimeSafety::check("posix_memalign");
+        return systemMemalign(memory, alignment, size);
+    }
+
+    void free(void* memory)
+    {
+        if (memory == nullptr)
+            return;
+
+        RealtimeSafety::check("free");
+        systemFree(memory);
+    }
+}
+#endif
+
+#endif
@@ -0,0 +1,74 @@
+#pragma once
+#include <juce_core/juce_core.h>
+
+
+/**
+ * @brief Debug checker that reports everything on the audio thread that could block or allocate
+ *
+ * Only compiled in with the CMake option ANIMALSYNTH_RT_CHECKS. While a thread is inside a
+ * ANIMALSYNTH_REALTIME_SCOPE, every operator new/delete is reported, and on Linux also every
+ * malloc, calloc, realloc, posix_memalign and free, every pthread mutex lock, condition wait, sleep
+ * and blocking read/write. Each distinct call site is reported once, with a stack trace, to stderr;
+ * all of them are counted.
+ *
+ * The interposed C functions only take effect in executables (Standalone, AnimalRender, AnimalBench).
+ * Inside a plugin loaded by a host, the host's C library wins the symbol lookup, so there only
+ * operator new/delete are checked reliably. On other platforms C allocations are not checked at all.
+ * Without the option, all macros expand to nothing.
+ */
+namespace RealtimeSafety
+{
+   #if ANIMALSYNTH_RT_CHECKS
+    /**
+     * @brief Marks the current thread as rendering audio for as long as it exists
+     */
+    struct ScopedAudioThread
+    {
+        ScopedAudioThread() noexcept;
+        ~ScopedAudioThread() noexcept;
+    };
+
+    /**
+     * @brief Suspends the checks for a call that is known to be acceptable, e.g. a wake-up that only ever locks briefly
+     */
+    struct ScopedAllow
+    {
+        ScopedAllow() noexcept;
+        ~ScopedAllow() noexcept;
+    };
+
+    /**
+     * @brief Allows pthread_mutex_lock only, for a lock that is known to be uncontended.
+     *        Allocations, waits, sleeps and I/O inside it are still reported
+     */
+    struct ScopedAllowLocks
+    {
+        ScopedAllowLocks() noexcept;
+        ~ScopedAllowLocks() noexcept;
+    };
+
+    bool isAudioThread() noexcept;
+
+    /**
+     * @brief Reports a violation if the current thread is inside an audio scope.
+     *
+     * @param what Short description of the call, e.g. "operator new"
+     */
+    void check(const char* what) noexcept;
+
+    /**
+     * @return How many violations were found since the program started
+     */
+    int getNumViolations() noexcept;
+   #endif
+}
+
+#if ANIMALSYNTH_RT_CHECKS
+ #define ANIMALSYNTH_REALTIME_SCOPE const RealtimeSafety::ScopedAudioThread realtimeSafetyScope;
+ #define ANIMALSYNTH_REALTIME_ALLOW const RealtimeSafety::ScopedAllow realtimeSafetyAllow;
+ #define ANIMALSYNTH_REALTIME_ALLOW_LOCKS const RealtimeSafety::ScopedAllowLocks realtimeSafetyAllowLocks;
+#else
+ #define ANIMALSYNTH_REALTIME_SCOPE
+ #define ANIMALSYNTH_REALTIME_ALLOW
+ #define ANIMALSYNTH_REALTIME_ALLOW_LOCKS
+#endif
@@ -0,0 +1,57 @@
+#include "RepaintScheduler.h"
+
+
+RepaintScheduler::RepaintScheduler(juce::Component& hostComponent, std::function<bool()> activityCheck)
+    : host(hostComponent), isActive(std::move(activityCheck))
+{
+    startVBlank();
+}
+
+RepaintScheduler::~RepaintScheduler()
+{
+    stopTimer();
+}
+
+void RepaintScheduler::addClient(Client* client)
+{
+    if (std::find(clients.begin(), clients.end(), client) == clients.end())
+        clients.push_back(client);
+}
+
+void RepaintScheduler::removeClient(Client* client)
+{
+    clients.erase(std::remove(clients.begin(), clients.end(), client), clients.end());
+}
+
+/**
+ * @brief Refreshes every client, then falls back to idle polling once the synth has gone quiet.
+ */
+void RepaintScheduler::tick()
+{
+    for (auto* client : clients)
+        client->refresh();
+
+    framesSinceActive = isActive() ? 0 : framesSinceActive + 1;
+
+    // The vblank is detached in timerCallback(): resetting it in here would destroy the callback that is running
+    if (!isTimerRunning() && framesSinceActive > framesToKeepRunning)
+        startTimerHz(idlePollHz);
+}
+
+void RepaintScheduler::timerCallback()
+{
+    vblank = {};
+    tick();
+
+    if (framesSinceActive == 0)
+    {
+        stopTimer();
+        startVBlank();
+    }
+}
+
+void RepaintScheduler::startVBlank()
+{
+    framesSinceActive = 0;
+    vblank = juce::VBlankAttachment(&host, [this] { tick(); });
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include <juce_gui_basics/juce_gui_basics.h>
+
+#include <functional>
+#include <vector>
+
+
+/**
+ * @brief Drives every visual component of an editor from a single display-synchronised callback
+ *
+ * While the synth is sounding, clients are refreshed once per vblank of the editor's display.
+ * A client only calls repaint() itself if what it shows has actually changed. Once the synth has been
+ * silent for a moment, the vblank callback is detached and a slow timer only checks for activity and
+ * picks up waveform switches, so a silent editor costs next to nothing.
+ */
+class RepaintScheduler : private juce::Timer
+{
+public:
+    /**
+     * @brief Anything the scheduler refreshes. Called on the message thread once per frame
+     */
+    struct Client
+    {
+        virtual ~Client() = default;
+        virtual void refresh() = 0;
+    };
+
+    static constexpr int idlePollHz = 10;
+    static constexpr int framesToKeepRunning = 30;  // Lets the scope scroll out and the animation settle
+
+    /**
+     * @param host The component whose display provides the vblank, usually the editor
+     * @param isActive Returns true while the synth is producing sound
+     */
+    RepaintScheduler(juce::Component& host, std::function<bool()> isActive);
+    ~RepaintScheduler() override;
+
+    void addClient(Client* client);
+    void removeClient(Client* client);
+
+private:
+    void tick();
+    void timerCallback() override;
+    void startVBlank();
+
+    juce::Component& host;
+    std::function<bool()> isActive;
+    std::vector<Client*> clients;
+
+    juce::VBlankAttachment vblank;
+    int framesSinceActive = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RepaintScheduler)
+};
@@ -3,41 +3,103 @@
 #include <juce_audio_basics/juce_audio_basics.h>
 #include <juce_core/juce_core.h>
 
+#include "PeakPyramid.h"
+#include "RepaintScheduler.h"
+#include "ScopeFifo.h"
+
+#include <array>
+#include <cmath>
+
 
 /**
  * @brief A simple Oscilloscope that draws smaller waves than JUCE's builtin one
+ *
+ * Reads min/max peaks from the processor's ScopeFifo on the message thread into a PeakPyramid, which is
+ * only touched by the message thread, so neither pulling nor painting needs a lock or allocates.
+ * Every pixel column is drawn as the filled range between the smallest and largest sample it covers, so
+ * nothing between two columns gets lost. The outline is only rebuilt when new peaks arrived or the size
+ * or zoom changed. Refreshed by a RepaintScheduler, it only repaints while there is something other than
+ * silence to show.
  */
-class ScaledVisualiserComponent : public juce::Component, private juce::Timer
+class ScaledVisualiserComponent : public juce::Component, public RepaintScheduler::Client
 {
 public:
     ScaledVisualiserComponent(int bufferSize = 2048)
-        : buffer(1, bufferSize)
+        : pyramid(bufferSize)
     {
-        buffer.clear();
-        startTimerHz(60); // ~60fps
+        setOpaque(true);
     }
 
+    /**
+     * @brief Sets the queue the peaks are read from.
+     *
+     * @param source The processor's scope queue, or nullptr to stop reading
+     */
+    void setSource(ScopeFifo* source)
+    {
+        fifo = source;
+    }
 
     /**
-     * @brief Copies samples from the given buffer into its own to display the Waveforms
+     * @brief Moves everything the audio thread has queued since the last call into the pyramid.
      *
-     * @param incoming The incoming Samples
+     * @return How many new peaks arrived
      */
-    void pushBuffer(const juce::AudioBuffer<float>& incoming)
+    int pullPeaks()
     {
-        const int numSamples = incoming.getNumSamples();
-        const float* channelData = incoming.getReadPointer(0); // mono
+        if (fifo == nullptr)
+            return 0;
 
-        const juce::SpinLock::ScopedLockType sl(bufferLock);
+        const int size = pyramid.getNumBins(0);
+        std::array<ScopePeak, 256> chunk;
 
-        if (numSamples >= buffer.getNumSamples())
+        // Anything older than one history length would be pushed out straight away
+        for (int excess = fifo->getNumReady() - size; excess > 0;)
         {
-            buffer.copyFrom(0, 0, channelData + (numSamples - buffer.getNumSamples()), buffer.getNumSamples());
+            const int skipped = fifo->pull(chunk.data(), juce::jmin(excess, static_cast<int>(chunk.size())));
+            excess -= skipped;
+
+            if (skipped == 0)
+                break;
+        }
+
+        int total = 0;
+
+        while (true)
+        {
+            const int pulled = fifo->pull(chunk.data(), static_cast<int>(chunk.size()));
+
+            if (pulled == 0)
+                break;
+
+            for (int i = 0; i < pulled; ++i)
+            {
+                const auto& peak = chunk[static_cast<size_t>(i)];
+                pyramid.push(peak);
+
+                // Track how long ago the last audible peak arrived
+                const bool audible = juce::jmax(std::abs(peak.min), std::abs(peak.max)) > silenceThreshold;
+                peaksSinceSignal = audible ? 0 : juce::jmin(peaksSinceSignal + 1, 2 * size);
+            }
+
+            total += pulled;
         }
-        else
+
+        return total;
+    }
+
+    /**
+     * @brief Called by the RepaintScheduler once per frame. Skips the repaint once the history is all silence.
+     */
+    void refresh() override
+    {
+        const int pulled = pullPeaks();
+
+        // Repaint while any signal is visible, plus the frame that scrolls the last of it out
+        if (pulled > 0 && peaksSinceSignal < pyramid.getNumBins(0) + pulled)
         {
-            buffer.copyFrom(0, 0, buffer.getReadPointer(0, numSamples), buffer.getNumSamples() - numSamples);
-            buffer.copyFrom(0, buffer.getNumSamples() - numSamples, channelData, numSamples);
+            geometryValid = false;
+            repaint();
         }
     }
 
@@ -48,14 +110,15 @@ public:
     void setHorizontalZoom(float zoom) // 1.0 = default
     {
         horizontalZoomFactor = zoom;
+        geometryValid = false;
         repaint();
     }
 
     /**
-     * @brief Takes the Samples in it's buffer and displays them.
+     * @brief Draws the min/max outline of the visible part of the history.
      *
      * I didn't like how the builtin simple oscilloscope would cut off the highest and lowest parts.
-     * So I made this zoomable one. It iterates over every sample and draws a path between them.
+     * So I made this zoomable one.
      *
      * @param g The graphic to be displayed.
      */
@@ -64,46 +127,102 @@ public:
         g.fillAll(juce::Colours::black);
         g.setColour(juce::Colours::lime);
 
-        const auto bounds = getLocalBounds().toFloat();
-        const float midY = bounds.getCentreY();
-        const float halfHeight = bounds.getHeight() * 0.5f * 0.8f;
+        const float scale = juce::Component::getApproximateScaleFactorForComponent(this);
 
-        juce::AudioBuffer<float> localCopy;
+        if (!geometryValid || scale != geometryScale)
         {
-            const juce::SpinLock::ScopedLockType sl(bufferLock);
-            localCopy.makeCopyOf(buffer);
+            buildOutline(scale);
+            geometryValid = true;
+            geometryScale = scale;
         }
 
-        const int numSamples = localCopy.getNumSamples();
-        const int samplesToRead = juce::jlimit(1, numSamples, static_cast<int>(numSamples / horizontalZoomFactor));
-        const int startSample = juce::jmax(0, numSamples - samplesToRead);
+        g.fillPath(outline);
+    }
 
-        juce::Path path;
+    void resized() override
+    {
+        geometryValid = false;
+    }
 
-        // First sample
-        float firstSample = localCopy.getSample(0, startSample);
-        float firstY = midY - firstSample * halfHeight;
-        path.startNewSubPath(0, firstY);
+private:
+    static constexpr float silenceThreshold = 1.0e-4f;
+    static constexpr float minimumThickness = 0.75f;    // Keeps flat stretches visible as a line
 
-        for (int x = 1; x < bounds.getWidth(); ++x)
+    /**
+     * @brief Picks the coarsest pyramid level that still has at least one bin per pixel column.
+     */
+    int getLevelFor(int numColumns) const noexcept
+    {
+        int level = 0;
+
+        while (level + 1 < pyramid.getNumLevels()
+               && static_cast<float>(pyramid.getNumBins(level + 1)) / horizontalZoomFactor >= static_cast<float>(numColumns))
+            ++level;
+
+        return level;
+    }
+
+    /**
+     * @brief Rebuilds the filled outline: the maxima left to right, then the minima right to left.
+     *
+     * @param scale Physical pixels per logical pixel, so a column is one device pixel wide
+     */
+    void buildOutline(float scale)
+    {
+        outline.clear();
+
+        const auto bounds = getLocalBounds().toFloat();
+        const int numColumns = juce::roundToInt(bounds.getWidth() * scale);
+
+        if (numColumns < 2)
+            return;
+
+        const float midY = bounds.getCentreY();
+        const float halfHeight = bounds.getHeight() * 0.5f * 0.8f;
+
+        const int level = getLevelFor(numColumns);
+        const int numBins = pyramid.getNumBins(level);
+        const int binsToRead = juce::jlimit(1, numBins, static_cast<int>(static_cast<float>(numBins) / horizontalZoomFactor));
+        const int startBin = numBins - binsToRead;
+
+        columns.resize(static_cast<size_t>(numColumns));
+
+        for (int x = 0; x < numColumns; ++x)
         {
-            float normX = static_cast<float>(x) / bounds.getWidth();
-            int sampleIndex = startSample + static_cast<int>(normX * samplesToRead);
-            sampleIndex = juce::jlimit(0, numSamples - 1, sampleIndex);
+            const int first = startBin + x * binsToRead / numColumns;
+            const int last = juce::jmax(first + 1, startBin + (x + 1) * binsToRead / numColumns);
+
+            auto peak = pyramid.getBin(level, first);
+
+            for (int bin = first + 1; bin < last; ++bin)
+                peak = ScopePeak::merge(peak, pyramid.getBin(level, bin));
 
-            float sample = localCopy.getSample(0, sampleIndex);
-            float y = midY - sample * halfHeight;
-            path.lineTo((float)x, y);
+            columns[static_cast<size_t>(x)] = peak;
         }
 
-        g.strokePath(path, juce::PathStrokeType(1.5f));
-    }
+        const float columnWidth = bounds.getWidth() / static_cast<float>(numColumns - 1);
+        auto toY = [=](float sample) { return midY - sample * halfHeight; };
 
-private:
-    void timerCallback() override { repaint(); }
+        outline.startNewSubPath(0.0f, toY(columns.front().max) - minimumThickness);
 
-    juce::AudioBuffer<float> buffer;
-    juce::SpinLock bufferLock;
+        for (int x = 1; x < numColumns; ++x)
+            outline.lineTo(static_cast<float>(x) * columnWidth, toY(columns[static_cast<size_t>(x)].max) - minimumThickness);
+
+        for (int x = numColumns; --x >= 0;)
+            outline.lineTo(static_cast<float>(x) * columnWidth, toY(columns[static_cast<size_t>(x)].min) + minimumThickness);
+
+        outline.closeSubPath();
+    }
+
+    ScopeFifo* fifo = nullptr;
+    PeakPyramid pyramid;
+    int peaksSinceSignal = 0;       // Age of the newest peak above the silence threshold
 
     float horizontalZoomFactor = 1.2f;
+
+    // Geometry of the last paint, reused until something changes
+    juce::Path outline;
+    std::vector<ScopePeak> columns;
+    bool geometryValid = false;
+    float geometryScale = 0.0f;
 };
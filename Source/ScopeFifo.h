@@ -0,0 +1,117 @@
+#pragma once
+#include <juce_core/juce_core.h>
+
+#include <limits>
+#include <vector>
+
+
+/**
+ * @brief Smallest and largest sample of a stretch of audio
+ */
+struct ScopePeak
+{
+    float min = 0.0f;
+    float max = 0.0f;
+
+    static ScopePeak merge(ScopePeak a, ScopePeak b) noexcept
+    {
+        return { juce::jmin(a.min, b.min), juce::jmax(a.max, b.max) };
+    }
+};
+
+
+/**
+ * @brief Wait-free single producer / single consumer queue of min/max peaks from the audio thread to the scope
+ *
+ * The audio thread already reduces its output to one ScopePeak per samplesPerPeak samples, which is the
+ * bottom level of the scope's peak pyramid. The scope never sees raw samples and never has to scan them.
+ *
+ * The processor owns it and pushes every block, whether an editor is open or not. When nobody reads,
+ * the queue simply fills up and further peaks are dropped, so pushing never blocks and never allocates.
+ */
+class ScopeFifo
+{
+public:
+    static constexpr int capacity = 4096;       // In peaks
+    static constexpr int samplesPerPeak = 2;
+
+    ScopeFifo() : peaks(static_cast<size_t>(capacity)) {}
+
+    /**
+     * @brief Audio thread only. Reduces the samples to peaks and queues as many of the newest ones as there is room for.
+     *
+     * A peak that is not complete at the end of a block is carried over into the next one.
+     * Double blocks are rounded to float, the scope does not need more.
+     */
+    template <typename SampleType>
+    void push(const SampleType* source, int numSamples) noexcept
+    {
+        const int numPeaks = (pendingSamples + numSamples) / samplesPerPeak;
+        const int numToWrite = juce::jmin(numPeaks, fifo.getFreeSpace());
+        int numToSkip = numPeaks - numToWrite;
+
+        int start1, size1, start2, size2;
+        fifo.prepareToWrite(numToWrite, start1, size1, start2, size2);
+
+        int written = 0;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const auto value = static_cast<float>(source[i]);
+            pending.min = juce::jmin(pending.min, value);
+            pending.max = juce::jmax(pending.max, value);
+
+            if (++pendingSamples < samplesPerPeak)
+                continue;
+
+            if (numToSkip > 0)
+            {
+                --numToSkip;
+            }
+            else
+            {
+                peaks[static_cast<size_t>(written < size1 ? start1 + written : start2 + written - size1)] = pending;
+                ++written;
+            }
+
+            pending = emptyPeak();
+            pendingSamples = 0;
+        }
+
+        fifo.finishedWrite(size1 + size2);
+    }
+
+    /**
+     * @brief Reader thread only. Moves up to maxPeaks of the oldest queued peaks into destination.
+     *
+     * @return How many peaks were copied
+     */
+    int pull(ScopePeak* destination, int maxPeaks) noexcept
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToRead(maxPeaks, start1, size1, start2, size2);
+
+        std::copy(peaks.data() + start1, peaks.data() + start1 + size1, destination);
+        std::copy(peaks.data() + start2, peaks.data() + start2 + size2, destination + size1);
+
+        fifo.finishedRead(size1 + size2);
+        return size1 + size2;
+    }
+
+    int getNumReady() const noexcept { return fifo.getNumReady(); }
+
+private:
+    static ScopePeak emptyPeak() noexcept
+    {
+        return { std::numeric_limits<float>::max(), std::numeric_limits<float>::lowest() };
+    }
+
+    juce::AbstractFifo fifo{ capacity };
+    std::vector<ScopePeak> peaks;
+
+    // Audio thread only
+    ScopePeak pending = emptyPeak();
+    int pendingSamples = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ScopeFifo)
+};
@@ -0,0 +1,25 @@
+#pragma once
+#include <atomic>
+
+
+/**
+ * @brief Lock-free channel the audio thread uses to publish visual state.
+ *
+ * The processor owns one of these and writes to it once per block, whether or not an editor exists.
+ * UI components that want to follow the sound (e.g. the wildlifeCam) poll it once per frame from the editor's RepaintScheduler.
+ * Every member is a relaxed atomic, so neither side ever blocks the other.
+ */
+struct VisualFeedback
+{
+    /// Level of the amplitude envelope at the end of the last rendered block (0..1)
+    std::atomic<float> envelopeLevel{ 0.0f };
+
+    /// Waveform (animal) that was rendered in the last block
+    std::atomic<int> waveformIndex{ 0 };
+
+    void publish(float level, int waveform) noexcept
+    {
+        envelopeLevel.store(level, std::memory_order_relaxed);
+        waveformIndex.store(waveform, std::memory_order_relaxed);
+    }
+};
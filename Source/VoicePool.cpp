@@ -0,0 +1,123 @@
+#include "VoicePool.h"
+
+
+/**
+ * @brief Allocates and initialises the state of every voice.
+ *
+ * @param numberOfVoices How many voices the pool holds, clamped to [minVoices, maxVoices]
+ * @param sampleRate The current sample rate
+ * @param maximumBlockSize The largest block the host will ask for
+ */
+void VoicePool::prepare(int numberOfVoices, double sampleRate, int maximumBlockSize)
+{
+    numVoices = juce::jlimit(minVoices, maxVoices, numberOfVoices);
+    blockSize = juce::jmax(1, maximumBlockSize);
+
+    // Rounded up to powers of two, so the delay lines wrap with a mask
+    const int combLength = DelayLine<double>::getCapacityFor(static_cast<int>(std::ceil(sampleRate * maxCombSeconds)));
+    const int echoLength = DelayLine<double>::getCapacityFor(static_cast<int>(std::ceil(sampleRate * maxEchoSeconds)));
+
+    const int modulationLength = numModulationBlocks * blockSize;
+    const int oversamplingLength = Oversampler::getWorkspaceSize(blockSize);  // Enough for 8x, the factor can change at any time
+
+    // One block per sample type: [scratch x N][modulation x N][oversampling x N] and [comb x N][echo x N]
+    sampleMemory.assign(static_cast<size_t>(numVoices) * static_cast<size_t>(blockSize + modulationLength + oversamplingLength), 0.0f);
+    delayMemory.assign(static_cast<size_t>(numVoices) * static_cast<size_t>(combLength + echoLength), 0.0);
+
+    float* scratchRegion = sampleMemory.data();
+    float* modulationRegion = scratchRegion + static_cast<size_t>(numVoices) * blockSize;
+    float* oversamplingRegion = modulationRegion + static_cast<size_t>(numVoices) * modulationLength;
+    double* combRegion = delayMemory.data();
+    double* echoRegion = combRegion + static_cast<size_t>(numVoices) * combLength;
+
+    common.clear();
+    sine.clear();
+    saw.clear();
+    square.clear();
+    triangle.clear();
+    blep.clear();
+    oversampler.clear();
+
+    common.resize(static_cast<size_t>(numVoices));
+    sine.resize(static_cast<size_t>(numVoices));
+    saw.resize(static_cast<size_t>(numVoices));
+    square.resize(static_cast<size_t>(numVoices));
+    triangle.resize(static_cast<size_t>(numVoices));
+    blep.resize(static_cast<size_t>(numVoices));
+    oversampler.resize(static_cast<size_t>(numVoices));
+
+    // Builds the shared minBLEP table, half-band filters, waveshaper curves and wavetables here rather than on the first note
+    MinBlepTable::getInstance();
+    Oversampler::prepareCoefficients();
+    Waveshaper::getInstance();
+    wavetables = WavetableBank::getForSampleRate(sampleRate);
+
+    for (int i = 0; i < numVoices; ++i)
+    {
+        const auto v = static_cast<size_t>(i);
+
+        common[v].adsr.setSampleRate(sampleRate);
+        common[v].scratch = scratchRegion + v * static_cast<size_t>(blockSize);
+        common[v].modulation = modulationRegion + v * static_cast<size_t>(modulationLength);
+        oversampler[v].prepare(oversamplingRegion + v * static_cast<size_t>(oversamplingLength), blockSize);
+
+        sine[v].filter.prepare(sampleRate);
+        sine[v].filter.setType(ModulatedSvf<float>::Type::bandpass);
+        sine[v].filter.setParameters(1000.0f, 0.8f);
+
+        saw[v].formantFilter.prepare(sampleRate);
+        saw[v].formantFilter.setType(ModulatedSvf<float>::Type::bandpass);
+        saw[v].comb.prepare(combRegion + v * static_cast<size_t>(combLength), combLength);
+
+        square[v].barkFilter.prepare(sampleRate);
+        square[v].barkFilter.setType(ModulatedSvf<float>::Type::bandpass);
+        square[v].barkFilter.setParameters(800.0f, 1.0f);
+
+        triangle[v].echo.prepare(echoRegion + v * static_cast<size_t>(echoLength), echoLength);
+    }
+}
+
+/**
+ * @brief Clears filters and delay lines of a voice that has finished or is being stolen.
+ *
+ * Runs on the audio thread, so only the state of the animal the voice was playing is cleared.
+ * The other animals' state has not been touched since their last reset.
+ *
+ * @param index The voice slot to reset
+ */
+void VoicePool::resetVoice(int index)
+{
+    const auto v = static_cast<size_t>(index);
+
+    common[v].adsr.reset();
+    common[v].level = 0.0f;
+
+    switch (static_cast<WaveformType>(common[v].waveform))
+    {
+        case WaveformType::Sine:
+            sine[v].filter.reset();
+            sine[v].filterEnvelope = 0.0f;
+            break;
+
+        case WaveformType::Saw:
+            saw[v].formantFilter.reset();
+            saw[v].dcBlockerInput = 0.0;
+            saw[v].dcBlockerOutput = 0.0;
+            saw[v].comb.reset();
+            blep[v].reset();
+            oversampler[v].reset();
+            break;
+
+        case WaveformType::Square:
+            square[v].barkFilter.reset();
+            square[v].lastBitcrushedSample = 0.0f;
+            square[v].bitcrushCounter = 0;
+            blep[v].reset();
+            oversampler[v].reset();
+            break;
+
+        case WaveformType::Triangle:
+            triangle[v].echo.reset();
+            break;
+    }
+}
@@ -0,0 +1,146 @@
+#pragma once
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_dsp/juce_dsp.h>
+
+#include "BandLimitedOscillator.h"
+#include "DelayLine.h"
+#include "ModulatedSvf.h"
+#include "Oversampler.h"
+#include "Waveshaper.h"
+#include "WavetableBank.h"
+
+#include <memory>
+#include <vector>
+
+
+/**
+ * @brief The four animals, stored as int in CommonVoiceState::waveform
+ */
+enum class WaveformType
+{
+    Sine,
+    Saw,
+    Square,
+    Triangle
+};
+
+/// === Per-voice state ===
+// Every voice owns one slot in each of these arrays. The arrays are split by animal so a voice
+// only ever touches the memory of the algorithm it is playing, which keeps large pools cache-friendly.
+
+/**
+ * @brief State every voice needs regardless of the animal it plays
+ */
+struct CommonVoiceState
+{
+    juce::ADSR adsr;
+    double phase = 0.0;
+    double phaseIncrement = 0.0;
+    int waveform = 0;           // WaveformType of the current note, only that animal's state is touched
+
+    float level = 0.0f;         // Last envelope value, used for voice stealing and the visuals
+    float* scratch = nullptr;   // Mono render buffer of maximumBlockSize samples
+    float* modulation = nullptr;    // Two LFO blocks of maximumBlockSize samples each
+};
+
+/**
+ * @brief "Howl" state: vibrato, tremolo and the enveloped bandpass
+ */
+struct SineVoiceState
+{
+    ModulatedSvf<float> filter;
+    float filterEnvelope = 0.0f;
+    float filterEnvIncrement = 0.0f;
+
+    double vibratoPhase = 0.0;
+    double tremoloPhase = 0.0;
+};
+
+/**
+ * @brief "Growl" state: comb filter, formant filter and the DC blocker behind the tube curve
+ *
+ * The comb and the DC blocker feed back into themselves for thousands of samples, so they run in double.
+ */
+struct SawVoiceState
+{
+    ModulatedSvf<float> formantFilter;
+
+    double dcBlockerInput = 0.0;
+    double dcBlockerOutput = 0.0;
+
+    DelayLine<double> comb;
+};
+
+/**
+ * @brief "Bark" state: punch envelope, bitcrusher and bark filter envelope
+ */
+struct SquareVoiceState
+{
+    ModulatedSvf<float> barkFilter;
+    float barkEnvelope = 0.0f;
+    float barkDecayRate = 0.0f;
+
+    float punchLevel = 0.0f;
+    float punchDecayRate = 0.0f;
+
+    float lastBitcrushedSample = 0.0f;
+    int bitcrushCounter = 0;
+};
+
+/**
+ * @brief "Chirp" state: pitch glide, chirp LFO and echo
+ */
+struct TriangleVoiceState
+{
+    double glideCurrentFreq = 0.0;
+    double glideTargetFreq = 0.0;
+    double glideStep = 0.0;
+    int glideSamplesLeft = 0;
+
+    double chirpPhase = 0.0;
+
+    DelayLine<double> echo;     // Feeds back into itself, so it runs in double like the comb
+};
+
+
+/**
+ * @brief Preallocated storage for all voices of the AnimalSynthesiser
+ *
+ * Everything a voice needs is allocated in prepare(), which is only ever called from prepareToPlay.
+ * Starting, stealing or finishing a note never allocates.
+ * All sample memory lives in two blocks: float for the render scratch, LFO blocks and oversampling buffers,
+ * double for the comb and echo lines.
+ */
+class VoicePool
+{
+public:
+    static constexpr int minVoices = 8;
+    static constexpr int maxVoices = 64;
+    static constexpr int defaultVoices = 16;
+
+    static constexpr double maxCombSeconds = 0.05;  // 50 ms, sawCombTime goes up to 30 ms
+    static constexpr double maxEchoSeconds = 0.5;   // 500 ms, triEchoTime goes up to 250 ms
+    static constexpr int numModulationBlocks = 2;   // The sine runs vibrato and tremolo at once
+
+    void prepare(int numberOfVoices, double sampleRate, int maximumBlockSize);
+    void resetVoice(int index);
+
+    int size() const noexcept { return numVoices; }
+    int getMaximumBlockSize() const noexcept { return blockSize; }
+
+    std::vector<CommonVoiceState> common;
+    std::vector<SineVoiceState> sine;
+    std::vector<SawVoiceState> saw;
+    std::vector<SquareVoiceState> square;
+    std::vector<TriangleVoiceState> triangle;
+    std::vector<MinBlepBuffer> blep;           // minBLEP corrections of the saw and square oscillators
+    std::vector<Oversampler> oversampler;      // Around the saw waveshaper and the square bitcrusher
+
+    std::shared_ptr<const WavetableBank> wavetables;    // Shared with every other pool running at this sample rate
+
+private:
+    std::vector<float> sampleMemory;
+    std::vector<double> delayMemory;
+    int numVoices = 0;
+    int blockSize = 0;
+};
@@ -0,0 +1,301 @@
+#include "VoiceRenderPool.h"
+#include "RealtimeSafety.h"
+
+#include <thread>
+#include <type_traits>
+
+
+/**
+ * @brief A single real-time render thread. All of its logic lives in VoiceRenderPool::runWorker
+ */
+class VoiceRenderPool::Worker : public juce::Thread
+{
+public:
+    Worker(VoiceRenderPool& owner, int index)
+        : juce::Thread("AnimalSynth voice worker " + juce::String(index)), pool(owner), workerIndex(index)
+    {
+    }
+
+    void run() override { pool.runWorker(*this); }
+
+    VoiceRenderPool& pool;
+    const int workerIndex;
+
+    juce::WaitableEvent wakeEvent;
+    std::atomic<bool> sleeping{ false };
+};
+
+
+VoiceRenderPool::VoiceRenderPool()
+{
+}
+
+VoiceRenderPool::~VoiceRenderPool()
+{
+    release();
+}
+
+/**
+ * @brief Starts the worker threads and allocates their scratch buffers. Call from prepareToPlay only.
+ *
+ * @param numberOfWorkers Threads besides the audio thread, 0 disables multi-threaded rendering
+ * @param numChannels Number of output channels
+ * @param maximumBlockSize The largest block the host will ask for
+ */
+void VoiceRenderPool::prepare(int numberOfWorkers, int numChannels, int maximumBlockSize)
+{
+    release();
+
+    numWorkers = juce::jlimit(0, maxWorkers, numberOfWorkers);
+
+    if (numWorkers == 0)
+        return;
+
+    slots = std::make_unique<WorkerSlot[]>(static_cast<size_t>(numWorkers));
+    ranges = std::make_unique<JobRange[]>(static_cast<size_t>(numWorkers + 1));
+
+    for (int i = 0; i < numWorkers; ++i)
+    {
+        slots[i].scratch.setSize(numChannels, maximumBlockSize);
+        slots[i].scratch.clear();
+    }
+
+    for (int i = 0; i < numWorkers; ++i)
+    {
+        workers.push_back(std::make_unique<Worker>(*this, i));
+        workers.back()->startRealtimeThread(juce::Thread::RealtimeOptions{}.withPriority(10));
+    }
+}
+
+/**
+ * @brief Stops all workers. Rendering falls back to the calling thread afterwards.
+ */
+void VoiceRenderPool::release()
+{
+    for (auto& worker : workers)
+        worker->signalThreadShouldExit();
+
+    for (auto& worker : workers)
+    {
+        worker->wakeEvent.signal();
+        worker->stopThread(1000);
+    }
+
+    workers.clear();
+    numWorkers = 0;
+}
+
+/**
+ *
+ * @return True if the workers' scratch buffers can hold the given range of the output
+ */
+template <typename SampleType>
+bool VoiceRenderPool::canRender(const juce::AudioBuffer<SampleType>& output, int startSample, int numSamples) const noexcept
+{
+    if (numWorkers == 0)
+        return false;
+
+    const auto& scratch = slots[0].scratch;
+    return output.getNumChannels() <= scratch.getNumChannels()
+        && startSample + numSamples <= scratch.getNumSamples();
+}
+
+/**
+ * @brief Renders all given voices into the output, spread across the audio thread and the workers.
+ *
+ * Returns once every voice has been rendered and summed. Check canRender() first.
+ */
+template <typename SampleType>
+void VoiceRenderPool::render(juce::SynthesiserVoice* const* voices, int numVoices,
+                             juce::AudioBuffer<SampleType>& output, int startSample, int numSamples)
+{
+    jassert(canRender(output, startSample, numSamples));
+
+    // === Set up the dispatch. No worker is inside it at this point ===
+    jobVoices = voices;
+    renderStart = startSample;
+    renderLength = numSamples;
+    numParticipants = numWorkers + 1;
+
+    for (int p = 0; p < numParticipants; ++p)
+    {
+        ranges[p].next.store(numVoices * p / numParticipants, std::memory_order_relaxed);
+        ranges[p].end = numVoices * (p + 1) / numParticipants;
+    }
+
+    for (int w = 0; w < numWorkers; ++w)
+        slots[w].usedScratch.store(false, std::memory_order_relaxed);
+
+    remainingJobs.store(numVoices, std::memory_order_relaxed);
+    dispatchOpen.store(true);
+    generation.fetch_add(1, std::memory_order_release);
+
+    for (auto& worker : workers)
+    {
+        // Only reached when a worker fell asleep, which takes a few ms without any block to render
+        ANIMALSYNTH_REALTIME_ALLOW_LOCKS
+
+        if (worker->sleeping.load())
+            worker->wakeEvent.signal();
+    }
+
+    // === The audio thread renders straight into the output ===
+    for (int job = claimJob(0); job >= 0; job = claimJob(0))
+    {
+        jobVoices[job]->renderNextBlock(output, startSample, numSamples);
+        remainingJobs.fetch_sub(1, std::memory_order_release);
+    }
+
+    while (remainingJobs.load(std::memory_order_acquire) > 0)
+        std::this_thread::yield();
+
+    // Close the dispatch and wait for late workers to leave before anything is changed again.
+    // Store and load are both seq_cst, like the worker's fetch_add and load in participate(): either the
+    // worker sees the dispatch closed, or this loop sees the worker. With an acquire load the store could be
+    // reordered after it, and both sides could miss each other
+    dispatchOpen.store(false);
+
+    while (activeWorkers.load() > 0)
+        std::this_thread::yield();
+
+    // === Sum the workers' scratch buffers ===
+    for (int w = 0; w < numWorkers; ++w)
+    {
+        if (!slots[w].usedScratch.load(std::memory_order_relaxed))
+            continue;
+
+        for (int channel = 0; channel < output.getNumChannels(); ++channel)
+        {
+            if constexpr (std::is_same_v<SampleType, float>)
+            {
+                output.addFrom(channel, startSample, slots[w].scratch, channel, startSample, numSamples);
+            }
+            else
+            {
+                const float* scratch = slots[w].scratch.getReadPointer(channel, startSample);
+                SampleType* destination = output.getWritePointer(channel, startSample);
+
+                for (int i = 0; i < numSamples; ++i)
+                    destination[i] += static_cast<SampleType>(scratch[i]);
+            }
+        }
+    }
+}
+
+template bool VoiceRenderPool::canRender(const juce::AudioBuffer<float>&, int, int) const noexcept;
+template bool VoiceRenderPool::canRender(const juce::AudioBuffer<double>&, int, int) const noexcept;
+template void VoiceRenderPool::render(juce::SynthesiserVoice* const*, int, juce::AudioBuffer<float>&, int, int);
+template void VoiceRenderPool::render(juce::SynthesiserVoice* const*, int, juce::AudioBuffer<double>&, int, int);
+
+/**
+ * @brief Converts the busy time collected during the last block into a utilisation per worker.
+ *
+ * @param blockTicks How long the whole block took to render, in high resolution ticks
+ */
+void VoiceRenderPool::publishUtilisation(juce::int64 blockTicks) noexcept
+{
+    for (int w = 0; w < numWorkers; ++w)
+    {
+        const auto busy = slots[w].busyTicks.exchange(0, std::memory_order_relaxed);
+        const float utilisation = blockTicks > 0 ? static_cast<float>(busy) / static_cast<float>(blockTicks) : 0.0f;
+        slots[w].utilisation.store(juce::jlimit(0.0f, 1.0f, utilisation), std::memory_order_relaxed);
+    }
+}
+
+/**
+ *
+ * @param worker Index of the worker thread
+ * @return Share of the last block (0..1) the worker spent rendering voices
+ */
+float VoiceRenderPool::getWorkerUtilisation(int worker) const noexcept
+{
+    if (!juce::isPositiveAndBelow(worker, numWorkers))
+        return 0.0f;
+
+    return slots[worker].utilisation.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Takes the next voice from the participant's own range, or steals one from another range.
+ *
+ * @return Index into the job list, -1 if every voice has been claimed
+ */
+int VoiceRenderPool::claimJob(int participant) noexcept
+{
+    for (int i = 0; i < numParticipants; ++i)
+    {
+        auto& range = ranges[(participant + i) % numParticipants];
+
+        if (range.next.load(std::memory_order_relaxed) >= range.end)
+            continue;
+
+        const int job = range.next.fetch_add(1, std::memory_order_acq_rel);
+
+        if (job < range.end)
+            return job;
+    }
+
+    return -1;
+}
+
+/**
+ * @brief Lets a worker join the current dispatch, if there still is one.
+ */
+void VoiceRenderPool::participate(int workerIndex)
+{
+    activeWorkers.fetch_add(1);
+
+    if (dispatchOpen.load())
+    {
+        ANIMALSYNTH_REALTIME_SCOPE
+        auto& slot = slots[workerIndex];
+        const auto startTicks = juce::Time::getHighResolutionTicks();
+        bool cleared = false;
+
+        for (int job = claimJob(workerIndex + 1); job >= 0; job = claimJob(workerIndex + 1))
+        {
+            if (!cleared)
+            {
+                for (int channel = 0; channel < slot.scratch.getNumChannels(); ++channel)
+                    slot.scratch.clear(channel, renderStart, renderLength);
+
+                slot.usedScratch.store(true, std::memory_order_relaxed);
+                cleared = true;
+            }
+
+            jobVoices[job]->renderNextBlock(slot.scratch, renderStart, renderLength);
+            remainingJobs.fetch_sub(1, std::memory_order_release);
+        }
+
+        slot.busyTicks.fetch_add(juce::Time::getHighResolutionTicks() - startTicks, std::memory_order_relaxed);
+    }
+
+    activeWorkers.fetch_sub(1, std::memory_order_release);
+}
+
+void VoiceRenderPool::runWorker(Worker& worker)
+{
+    constexpr int spinsBeforeSleep = 2000;
+    auto seenGeneration = generation.load(std::memory_order_acquire);
+
+    while (!worker.threadShouldExit())
+    {
+        // Blocks arrive in quick succession, so spin a little before going to sleep
+        for (int spin = 0; spin < spinsBeforeSleep && generation.load(std::memory_order_acquire) == seenGeneration; ++spin)
+            std::this_thread::yield();
+
+        if (generation.load(std::memory_order_acquire) == seenGeneration)
+        {
+            worker.sleeping.store(true);
+
+            if (generation.load() == seenGeneration && !worker.threadShouldExit())
+                worker.wakeEvent.wait(5);
+
+            worker.sleeping.store(false);
+            continue;
+        }
+
+        seenGeneration = generation.load(std::memory_order_acquire);
+        participate(worker.workerIndex);
+    }
+}
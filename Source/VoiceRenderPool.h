@@ -0,0 +1,83 @@
+#pragma once
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_core/juce_core.h>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+
+/**
+ * @brief Fixed pool of real-time worker threads that render voices in parallel
+ *
+ * For every render call the active voices are split into one job range per participant
+ * (the audio thread plus every worker). Each participant works through its own range and,
+ * once that is empty, steals single voices from the others. Claiming a voice is one atomic
+ * fetch_add, no locks are taken on the hot path.
+ *
+ * Workers render into their own scratch buffer; the audio thread renders straight into the
+ * output and sums the scratch buffers once all voices are done. The scratch buffers are always
+ * float, the output may be float or double.
+ */
+class VoiceRenderPool
+{
+public:
+    static constexpr int maxWorkers = 16;
+
+    VoiceRenderPool();
+    ~VoiceRenderPool();
+
+    void prepare(int numberOfWorkers, int numChannels, int maximumBlockSize);
+    void release();
+
+    int getNumWorkers() const noexcept { return numWorkers; }
+
+    template <typename SampleType>
+    bool canRender(const juce::AudioBuffer<SampleType>& output, int startSample, int numSamples) const noexcept;
+
+    template <typename SampleType>
+    void render(juce::SynthesiserVoice* const* voices, int numVoices,
+                juce::AudioBuffer<SampleType>& output, int startSample, int numSamples);
+
+    void publishUtilisation(juce::int64 blockTicks) noexcept;
+    float getWorkerUtilisation(int worker) const noexcept;
+
+private:
+    class Worker;
+
+    struct alignas(64) JobRange
+    {
+        std::atomic<int> next{ 0 };
+        int end = 0;
+    };
+
+    struct alignas(64) WorkerSlot
+    {
+        juce::AudioBuffer<float> scratch;
+        std::atomic<bool> usedScratch{ false };
+        std::atomic<juce::int64> busyTicks{ 0 };
+        std::atomic<float> utilisation{ 0.0f };
+    };
+
+    int claimJob(int participant) noexcept;
+    void participate(int workerIndex);
+    void runWorker(Worker& worker);
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::unique_ptr<WorkerSlot[]> slots;
+    std::unique_ptr<JobRange[]> ranges;
+    int numWorkers = 0;
+
+    // Description of the current dispatch. Only written by the audio thread while no worker is inside it
+    juce::SynthesiserVoice* const* jobVoices = nullptr;
+    int renderStart = 0;
+    int renderLength = 0;
+    int numParticipants = 1;
+
+    std::atomic<juce::uint32> generation{ 0 };
+    std::atomic<bool> dispatchOpen{ false };
+    std::atomic<int> activeWorkers{ 0 };
+    std::atomic<int> remainingJobs{ 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (VoiceRenderPool)
+};
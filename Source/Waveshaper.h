@@ -0,0 +1,73 @@
+#pragma once
+#include <juce_dsp/juce_dsp.h>
+
+#include <array>
+#include <vector>
+
+
+/**
+ * @brief Transfer curves of the saw's waveshaper. The Shape knob morphs each one from hard to soft
+ */
+enum class WaveshaperCurve
+{
+    Clip,       // Hard clip to tanh, the original growl
+    Foldback,   // Triangle fold to sine fold, anything beyond full scale is mirrored back
+    Tube        // Asymmetric clip to asymmetric tanh, adds even harmonics
+};
+
+
+/**
+ * @brief Tabulated waveshaper: no tanh, no clamping and no branches per sample
+ *
+ * Every curve is stored as a hard and a soft table over the driven input (input * drive). Since the
+ * output is linear in the shape, hard + shape * (soft - hard), the morph is exact without a table per
+ * shape value, and drive stays a plain gain in front of the lookup. So the tables never have to be
+ * rebuilt when Drive or Shape move, not even while they ramp sample by sample; they are built once
+ * per process and shared by every voice and instance.
+ *
+ * Each table entry holds value and slope of its segment, so the linear interpolation reads a single
+ * 16 byte entry per curve. Driven inputs beyond maxInput read the last entry.
+ */
+class Waveshaper
+{
+public:
+    static constexpr float maxInput = 32.0f;    // Drive 10 on an input of 3.2, which the resonant formant filter can reach
+    static constexpr int numSegments = 4096;    // 64 per unit, interpolation error below -80 dB
+
+    static const Waveshaper& getInstance();
+
+    /**
+     * @brief Shapes a single sample
+     */
+    float processSample(WaveshaperCurve curve, float input, float drive, float shape) const noexcept
+    {
+        const float position = juce::jlimit(0.0f, static_cast<float>(numSegments), (input * drive + maxInput) * segmentsPerUnit);
+        const int index = static_cast<int>(position);
+        const float fraction = position - static_cast<float>(index);
+
+        const Segment& segment = tables[static_cast<size_t>(curve)][static_cast<size_t>(index)];
+        const float hard = segment.hard + segment.hardSlope * fraction;
+        const float soft = segment.soft + segment.softSlope * fraction;
+
+        return hard + shape * (soft - hard);
+    }
+
+    /**
+     * @brief Shapes a block in place with constant drive and shape.
+     */
+    void process(WaveshaperCurve curve, float* samples, int numSamples, float drive, float shape) const noexcept;
+
+private:
+    Waveshaper();
+
+    struct Segment
+    {
+        float hard, hardSlope;
+        float soft, softSlope;
+    };
+
+    static constexpr float segmentsPerUnit = numSegments / (2.0f * maxInput);
+
+    // numSegments + 1 entries per curve, the last one holds the end value with zero slope
+    std::array<std::vector<Segment>, 3> tables;
+};
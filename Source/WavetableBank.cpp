@@ -0,0 +1,85 @@
+#include "WavetableBank.h"
+#include <juce_dsp/juce_dsp.h>
+
+#include <map>
+
+
+std::shared_ptr<const WavetableBank> WavetableBank::getForSampleRate(double sampleRate)
+{
+    static juce::CriticalSection cacheLock;
+    static std::map<int, std::weak_ptr<const WavetableBank>> cache;
+
+    const juce::ScopedLock lock(cacheLock);
+    auto& entry = cache[juce::roundToInt(sampleRate)];
+
+    if (auto bank = entry.lock())
+        return bank;
+
+    std::shared_ptr<const WavetableBank> bank(new WavetableBank(sampleRate));
+    entry = bank;
+    return bank;
+}
+
+/**
+ * @brief Builds every table from its Fourier series with one inverse FFT each.
+ *
+ * @param rate The sample rate the octave limits are computed for
+ */
+WavetableBank::WavetableBank(double rate)
+    : sampleRate(rate)
+{
+    constexpr int fftOrder = 11;
+    static_assert((1 << fftOrder) == tableSize, "fftOrder must match tableSize");
+
+    const double pi = juce::MathConstants<double>::pi;
+    const int maxHarmonic = tableSize / 2 - 1;
+
+    samples.assign(static_cast<size_t>(1 + (numShapes - 1) * numOctaves) * stride, 0.0f);
+
+    // === Sine ===
+    float* sineTable = samples.data();
+
+    for (int i = 0; i < stride; ++i)
+        sineTable[i] = static_cast<float>(std::sin(2.0 * pi * i / tableSize));
+
+    // === Saw, Square and Triangle ===
+    juce::dsp::FFT fft(fftOrder);
+    std::vector<float> bins(static_cast<size_t>(2 * tableSize));
+
+    // The FFT engines don't agree on how the inverse is scaled, so measure it with a unit sine
+    bins[3] = -1.0f;
+    fft.performRealOnlyInverseTransform(bins.data());
+    const double scale = 1.0 / bins[tableSize / 4];
+
+    for (int shape = saw; shape < numShapes; ++shape)
+    {
+        for (int octave = 0; octave < numOctaves; ++octave)
+        {
+            // Highest harmonic that stays below Nyquist at the top of this octave
+            const double topFrequency = lowestFrequency * std::pow(2.0, octave + 1);
+            const int harmonics = juce::jlimit(1, maxHarmonic, static_cast<int>(0.5 * sampleRate / topFrequency));
+
+            std::fill(bins.begin(), bins.end(), 0.0f);
+
+            for (int k = 1; k <= harmonics; ++k)
+            {
+                auto& re = bins[static_cast<size_t>(2 * k)];
+                auto& im = bins[static_cast<size_t>(2 * k + 1)];
+
+                switch (shape)
+                {
+                    case saw:       im = static_cast<float>(scale * 2.0 / (pi * k)); break;                           // 2p - 1
+                    case square:    im = (k % 2 == 1) ? static_cast<float>(-scale * 4.0 / (pi * k)) : 0.0f; break;    // +1, then -1
+                    case triangle:  re = (k % 2 == 1) ? static_cast<float>(scale * 8.0 / (pi * pi * k * k)) : 0.0f; break; // 1 at p = 0, -1 at p = 0.5
+                    default: break;
+                }
+            }
+
+            fft.performRealOnlyInverseTransform(bins.data());
+
+            float* table = samples.data() + getOffset(static_cast<Shape>(shape), octave);
+            std::copy(bins.begin(), bins.begin() + tableSize, table);
+            table[tableSize] = table[0];
+        }
+    }
+}
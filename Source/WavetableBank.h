@@ -0,0 +1,86 @@
+#pragma once
+#include <juce_core/juce_core.h>
+
+#include <memory>
+#include <vector>
+
+
+/**
+ * @brief Where the base waveforms of the voices come from
+ */
+enum class OscillatorEngine
+{
+    Analytic,   // Computed per sample: std::sin, naive or BLEP corrected waveforms
+    Wavetable   // Read from the shared, mip-mapped WavetableBank
+};
+
+
+/**
+ * @brief Band-limited, mip-mapped tables of the four base waveforms
+ *
+ * Every waveform except the sine has one table per octave, each holding only the harmonics that
+ * stay below Nyquist for the highest note of that octave. Since that limit depends on the sample
+ * rate, there is one bank per sample rate. Banks are built lazily on first request and shared by
+ * every voice of every plugin instance in the process. A bank is freed again once the last pool
+ * using it has been re-prepared or destroyed.
+ */
+class WavetableBank
+{
+public:
+    /// Same order as WaveformType
+    enum Shape { sine, saw, square, triangle, numShapes };
+
+    static constexpr int tableSize = 2048;
+    static constexpr int numOctaves = 10;
+    static constexpr double lowestFrequency = 20.0;     // Lower edge of the first octave
+
+    /**
+     * @brief Returns the bank for this sample rate, building it first if nobody holds it yet.
+     *
+     * Allocates and runs a few hundred FFTs on first use, so only call it from prepareToPlay.
+     */
+    static std::shared_ptr<const WavetableBank> getForSampleRate(double sampleRate);
+
+    /**
+     * @return The table to use for a note with this phase increment (frequency / sample rate)
+     */
+    int getOctave(double phaseIncrement) const noexcept
+    {
+        return juce::jlimit(0, numOctaves - 1, std::ilogb(phaseIncrement * sampleRate / lowestFrequency));
+    }
+
+    /**
+     * @brief Linearly interpolated lookup.
+     *
+     * @param shape Which waveform, the sine ignores the octave
+     * @param octave Result of getOctave()
+     * @param phase Oscillator phase (0..1)
+     */
+    float read(Shape shape, int octave, double phase) const noexcept
+    {
+        const float* table = getTable(shape, octave);
+        const double position = phase * tableSize;
+        const int i = static_cast<int>(position);
+        const float frac = static_cast<float>(position - i);
+
+        return table[i] + frac * (table[i + 1] - table[i]);
+    }
+
+    float sin(double phase) const noexcept { return read(sine, 0, phase); }
+
+private:
+    explicit WavetableBank(double sampleRate);
+
+    static constexpr int stride = tableSize + 1;        // One guard sample for the interpolation
+
+    static size_t getOffset(Shape shape, int octave) noexcept
+    {
+        const int table = shape == sine ? 0 : 1 + (shape - 1) * numOctaves + octave;
+        return static_cast<size_t>(table) * stride;
+    }
+
+    const float* getTable(Shape shape, int octave) const noexcept { return samples.data() + getOffset(shape, octave); }
+
+    double sampleRate;
+    std::vector<float> samples;
+};
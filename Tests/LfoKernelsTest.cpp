@@ -0,0 +1,109 @@
+#include <juce_core/juce_core.h>
+
+#include "../Source/LfoKernels.h"
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+
+/**
+ * @brief Accuracy check of the LFO kernels against std::sin, run by ctest
+ *
+ * The scalar and the SIMD polynomial are compared over a full turn, the SIMD one from an unaligned
+ * start so its scalar head and tail are covered too. renderSine is run for ten minutes of audio,
+ * where an accumulated phase would drift. Exit code 1 if any error is beyond its bound.
+ */
+namespace
+{
+    constexpr double maxPolynomialError = 4.0e-6;   // As documented on Lfo::sinTurns
+    constexpr int pointsPerTurn = 1 << 16;
+
+    double exactSin(double turns)
+    {
+        return std::sin(juce::MathConstants<double>::twoPi * turns);
+    }
+
+    bool report(const char* name, double maxError, double bound)
+    {
+        const bool passed = maxError < bound;
+        std::cout << (passed ? "PASS " : "FAIL ") << name << ": max error " << maxError << " (bound " << bound << ")" << std::endl;
+        return passed;
+    }
+
+    double scalarError()
+    {
+        double maxError = 0.0;
+
+        for (int i = 0; i <= pointsPerTurn; ++i)
+        {
+            const float phase = static_cast<float>(i) / pointsPerTurn;
+            maxError = juce::jmax(maxError, std::abs(Lfo::sinTurns(phase) - exactSin(phase)));
+        }
+
+        return maxError;
+    }
+
+    double simdError()
+    {
+        // One extra sample in front, so the block does not start on a SIMD boundary
+        std::vector<float> buffer(static_cast<size_t>(pointsPerTurn) + 2);
+        float* phases = buffer.data() + 1;
+
+        for (int i = 0; i <= pointsPerTurn; ++i)
+            phases[i] = static_cast<float>(i) / pointsPerTurn;
+
+        Lfo::sinTurns(phases, pointsPerTurn + 1);
+
+        double maxError = 0.0;
+
+        for (int i = 0; i <= pointsPerTurn; ++i)
+            maxError = juce::jmax(maxError, std::abs(phases[i] - exactSin(static_cast<float>(i) / pointsPerTurn)));
+
+        return maxError;
+    }
+
+    double longRenderError(bool ramping)
+    {
+        constexpr double sampleRate = 48000.0;
+        constexpr int blockSize = 512;
+        constexpr int numBlocks = static_cast<int>(sampleRate * 600.0) / blockSize;
+        constexpr float rate = 5.0f;
+
+        std::vector<float> rates(blockSize, rate);
+        const ParameterRamp rateRamp{ rates.data(), rate, ramping };
+        const ParameterRamp depth{ nullptr, 1.0f, false };
+
+        std::vector<float> output(blockSize);
+        double phase = 0.0;
+        double maxError = 0.0;
+
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            Lfo::renderSine(output.data(), phase, rateRamp, depth, 0, blockSize, sampleRate);
+
+            for (int i = 0; i < blockSize; ++i)
+            {
+                const double sample = static_cast<double>(block) * blockSize + i;
+                const double turns = std::fmod(sample * rate / sampleRate, 1.0);
+                maxError = juce::jmax(maxError, std::abs(output[static_cast<size_t>(i)] - exactSin(turns)));
+            }
+        }
+
+        return maxError;
+    }
+}
+
+int main()
+{
+    bool passed = true;
+
+    passed &= report("sinTurns, scalar", scalarError(), maxPolynomialError);
+    passed &= report("sinTurns, SIMD", simdError(), maxPolynomialError);
+
+    // The phase is rounded to float per sample, which adds up to one float ulp of a turn on top of the polynomial
+    passed &= report("renderSine, 10 min constant rate", longRenderError(false), 2.0 * maxPolynomialError);
+    passed &= report("renderSine, 10 min ramped rate", longRenderError(true), 2.0 * maxPolynomialError);
+
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,279 @@
+#include <juce_core/juce_core.h>
+#include <juce_events/juce_events.h>
+
+#include "../../Source/LfoKernels.h"
+#include "../../Source/PluginProcessor.h"
+#include "../../Source/Waveshaper.h"
+
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+
+/**
+ * @brief Measures the DSP headless and prints the results as JSON
+ *
+ * Usage: AnimalBench [--waveforms=sine,saw,square,triangle] [--blocks=64,256,1024] [--rates=44100,48000,96000]
+ *                    [--channels=1,2] [--voices=1,8,32] [--modes=realtime,offline] [--seconds=1] [--output=<file.json>]
+ *
+ * Every combination of the lists is one case: a fresh processor with that many notes held, rendering the
+ * given amount of audio through processBlock. The mode is what the processor is told about the host:
+ * "realtime" (the default) is live playback, "offline" a bounce, which switches to the offline oversampling.
+ * Each case reports ns per sample frame, the real-time factor and the worst block against its real-time
+ * budget. The LFO kernels and the waveshaper are measured on their own as well.
+ * Compare the JSON of two builds to catch regressions; the numbers are only comparable on the same machine.
+ */
+namespace
+{
+    using Clock = juce::int64;
+
+    double ticksToNanoseconds(Clock ticks)
+    {
+        return juce::Time::highResolutionTicksToSeconds(ticks) * 1.0e9;
+    }
+
+    juce::Array<int> parseList(const juce::ArgumentList& args, const juce::String& option, const juce::String& defaults)
+    {
+        const auto text = args.containsOption(option) ? args.getValueForOption(option) : defaults;
+        juce::Array<int> values;
+
+        for (const auto& token : juce::StringArray::fromTokens(text, ",", ""))
+            if (token.getIntValue() > 0)
+                values.add(token.getIntValue());
+
+        return values;
+    }
+
+    /**
+     * @brief Renders one configuration and returns its result as a JSON object.
+     */
+    juce::var runCase(int waveform, const juce::String& waveformName, int blockSize, int sampleRate, int numChannels, int numVoices,
+                      bool offline, double seconds, float& checksum)
+    {
+        AnimalSynthAudioProcessor processor;
+
+        auto layout = processor.getBusesLayout();
+        layout.getMainOutputChannelSet() = numChannels == 1 ? juce::AudioChannelSet::mono() : juce::AudioChannelSet::stereo();
+        processor.setBusesLayout(layout);
+
+        auto* waveformParameter = processor.parameters.getParameter(getParameterID(ParamId::waveform));
+        waveformParameter->setValueNotifyingHost(waveformParameter->convertTo0to1(static_cast<float>(waveform)));
+
+        processor.setVoiceCount(numVoices);
+        processor.setNonRealtime(offline);
+        processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+
+        juce::AudioBuffer<float> buffer(processor.getTotalNumOutputChannels(), blockSize);
+        juce::MidiBuffer midi;
+
+        // Every voice plays a held note, so the whole pool is busy for the entire measurement
+        for (int voice = 0; voice < numVoices; ++voice)
+            midi.addEvent(juce::MidiMessage::noteOn(1, 36 + voice % 72, 0.8f), 0);
+
+        // Warm-up: attack phase, caches, lazily built tables
+        const int warmupBlocks = juce::jmax(1, sampleRate / (10 * blockSize));
+
+        for (int block = 0; block < warmupBlocks; ++block)
+        {
+            buffer.clear();
+            processor.processBlock(buffer, midi);
+            midi.clear();
+        }
+
+        const int numBlocks = juce::jmax(1, juce::roundToInt(seconds * sampleRate / blockSize));
+        Clock total = 0, worst = 0;
+        int overBudget = 0;
+
+        const auto budget = static_cast<Clock>(static_cast<double>(blockSize) / sampleRate * static_cast<double>(juce::Time::getHighResolutionTicksPerSecond()));
+
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            buffer.clear();
+
+            const auto start = juce::Time::getHighResolutionTicks();
+            processor.processBlock(buffer, midi);
+            const auto elapsed = juce::Time::getHighResolutionTicks() - start;
+
+            total += elapsed;
+            worst = juce::jmax(worst, elapsed);
+            overBudget += elapsed > budget ? 1 : 0;
+            checksum += buffer.getSample(0, blockSize - 1);
+        }
+
+        processor.releaseResources();
+
+        const double frames = static_cast<double>(numBlocks) * blockSize;
+        const double cpuSeconds = juce::Time::highResolutionTicksToSeconds(total);
+
+        auto* result = new juce::DynamicObject();
+        result->setProperty("waveform", waveformName);
+        result->setProperty("mode", offline ? "offline" : "realtime");
+        result->setProperty("blockSize", blockSize);
+        result->setProperty("sampleRate", sampleRate);
+        result->setProperty("channels", numChannels);
+        result->setProperty("voices", numVoices);
+        result->setProperty("nsPerSample", ticksToNanoseconds(total) / frames);
+        result->setProperty("nsPerSamplePerVoice", ticksToNanoseconds(total) / (frames * numVoices));
+        result->setProperty("realTimeFactor", frames / sampleRate / juce::jmax(cpuSeconds, 1.0e-9));
+        result->setProperty("worstBlockLoad", static_cast<double>(worst) / static_cast<double>(budget));
+        result->setProperty("blocksOverBudget", overBudget);
+        return result;
+    }
+
+    /**
+     * @brief Times a kernel over a buffer of LFO phases (0 to 1, also a fair waveshaper input) and returns ns per sample.
+     */
+    template <typename Kernel>
+    double timeKernel(Kernel&& kernel, std::vector<float>& data, int repetitions, float& checksum)
+    {
+        std::vector<float> phases(data.size());
+
+        for (size_t i = 0; i < phases.size(); ++i)
+            phases[i] = static_cast<float>(i) / static_cast<float>(phases.size());
+
+        Clock best = std::numeric_limits<Clock>::max();
+
+        for (int run = 0; run < repetitions; ++run)
+        {
+            std::copy(phases.begin(), phases.end(), data.begin());
+
+            const auto start = juce::Time::getHighResolutionTicks();
+            kernel(data.data(), static_cast<int>(data.size()));
+            best = juce::jmin(best, juce::Time::getHighResolutionTicks() - start);
+
+            checksum += data[static_cast<size_t>(run) % data.size()];
+        }
+
+        return ticksToNanoseconds(best) / static_cast<double>(data.size());
+    }
+
+    juce::var runKernels(float& checksum)
+    {
+        constexpr int blockSize = 4096;
+        constexpr int repetitions = 2000;
+        std::vector<float> data(blockSize);
+
+        auto* result = new juce::DynamicObject();
+
+        result->setProperty("lfoStdSin", timeKernel([](float* x, int n)
+        {
+            for (int i = 0; i < n; ++i)
+                x[i] = std::sin(juce::MathConstants<float>::twoPi * x[i]);
+        }, data, repetitions, checksum));
+
+        result->setProperty("lfoPolynomialScalar", timeKernel([](float* x, int n)
+        {
+            for (int i = 0; i < n; ++i)
+                x[i] = Lfo::sinTurns(x[i]);
+        }, data, repetitions, checksum));
+
+        result->setProperty("lfoPolynomialSimd", timeKernel([](float* x, int n) { Lfo::sinTurns(x, n); }, data, repetitions, checksum));
+
+        result->setProperty("lfoRenderSine", timeKernel([](float* x, int n)
+        {
+            double phase = 0.0;
+            Lfo::renderSine(x, phase, { nullptr, 5.0f, false }, { nullptr, 0.5f, false }, 0, n, 48000.0);
+        }, data, repetitions, checksum));
+
+        const auto& waveshaper = Waveshaper::getInstance();
+
+        result->setProperty("waveshaperBlock", timeKernel([&waveshaper](float* x, int n)
+        {
+            waveshaper.process(WaveshaperCurve::Tube, x, n, 4.0f, 0.5f);
+        }, data, repetitions, checksum));
+
+        return result;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const juce::ArgumentList args(argc, argv);
+    const juce::ScopedJuceInitialiser_GUI juceInitialiser; // Message manager only, no window is ever created
+
+    const juce::StringArray waveformNames{ "sine", "saw", "square", "triangle" };
+    const auto selectedWaveforms = juce::StringArray::fromTokens(args.containsOption("--waveforms") ? args.getValueForOption("--waveforms")
+                                                                                                      : waveformNames.joinIntoString(","), ",", "");
+    const auto blockSizes = parseList(args, "--blocks", "64,256,1024");
+    const auto sampleRates = parseList(args, "--rates", "44100,48000,96000");
+    const auto channelCounts = parseList(args, "--channels", "1,2");
+    const auto voiceCounts = parseList(args, "--voices", "1,8,32");
+    const auto modes = juce::StringArray::fromTokens(args.containsOption("--modes") ? args.getValueForOption("--modes") : "realtime", ",", "");
+    const double seconds = args.containsOption("--seconds") ? args.getValueForOption("--seconds").getDoubleValue() : 1.0;
+
+    for (const auto& mode : modes)
+    {
+        if (mode.trim() != "realtime" && mode.trim() != "offline")
+        {
+            std::cerr << "Unknown mode: " << mode << std::endl;
+            return 1;
+        }
+    }
+
+    float checksum = 0.0f;
+    juce::Array<juce::var> cases;
+
+    for (const auto& name : selectedWaveforms)
+    {
+        const int waveform = waveformNames.indexOf(name.trim(), true);
+
+        if (waveform < 0)
+        {
+            std::cerr << "Unknown waveform: " << name << std::endl;
+            return 1;
+        }
+
+        for (const auto& mode : modes)
+        {
+            for (int blockSize : blockSizes)
+                for (int sampleRate : sampleRates)
+                    for (int channels : channelCounts)
+                        for (int voices : voiceCounts)
+                        {
+                            cases.add(runCase(waveform, waveformNames[waveform], blockSize, sampleRate, juce::jlimit(1, 2, channels), voices,
+                                              mode.trim() == "offline", seconds, checksum));
+                            std::cerr << "." << std::flush;
+                        }
+        }
+    }
+
+    std::cerr << std::endl;
+
+    auto* report = new juce::DynamicObject();
+    report->setProperty("version", ANIMALSYNTH_VERSION);
+    report->setProperty("cpu", juce::SystemStats::getCpuModel());
+    report->setProperty("simdLanes", static_cast<int>(juce::dsp::SIMDRegister<float>::size()));
+    report->setProperty("kernels", runKernels(checksum));
+    report->setProperty("cases", cases);
+    report->setProperty("checksum", checksum); // Keeps the optimiser from dropping the work
+
+    const auto json = juce::JSON::toString(juce::var(report));
+
+    if (args.containsOption("--output"))
+    {
+        const auto file = juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption("--output"));
+
+        if (!file.replaceWithText(json))
+        {
+            std::cerr << "Could not write " << file.getFullPathName() << std::endl;
+            return 1;
+        }
+    }
+    else
+    {
+        std::cout << json << std::endl;
+    }
+
+   #if ANIMALSYNTH_RT_CHECKS
+    // Timings with the checks compiled in are not representative, but the violations are
+    if (RealtimeSafety::getNumViolations() > 0)
+    {
+        std::cerr << RealtimeSafety::getNumViolations() << " real-time safety violations inside processBlock" << std::endl;
+        return 1;
+    }
+   #endif
+
+    return 0;
+}
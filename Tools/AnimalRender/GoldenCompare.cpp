@@ -0,0 +1,186 @@
+#include "GoldenCompare.h"
+
+#include <juce_dsp/juce_dsp.h>
+
+#include <cmath>
+
+
+namespace
+{
+    constexpr int fftOrder = 11;
+    constexpr int fftSize = 1 << fftOrder;
+    constexpr int hopSize = fftSize / 2;
+
+    // Bins quieter than this in both signals are noise floor and left out of the spectral distance
+    constexpr float floorDb = -100.0f;
+
+    /**
+     * @brief Magnitude spectrum of one windowed frame in dBFS, numSamples may be shorter than a frame (zero padded).
+     */
+    void frameSpectrum(const float* samples, int numSamples, juce::dsp::FFT& fft, juce::dsp::WindowingFunction<float>& window,
+                       std::vector<float>& scratch, std::vector<float>& decibels)
+    {
+        std::fill(scratch.begin(), scratch.end(), 0.0f);
+        std::copy(samples, samples + numSamples, scratch.begin());
+
+        window.multiplyWithWindowingTable(scratch.data(), static_cast<size_t>(fftSize));
+        fft.performFrequencyOnlyForwardTransform(scratch.data());
+
+        // A full scale sine ends up at 0 dB with the Hann window's gain of 1/2
+        const float normalisation = 4.0f / static_cast<float>(fftSize);
+
+        for (size_t bin = 0; bin < decibels.size(); ++bin)
+            decibels[bin] = juce::Decibels::gainToDecibels(scratch[bin] * normalisation, floorDb - 20.0f);
+    }
+}
+
+juce::var CompareResult::toVar(const juce::String& name) const
+{
+    auto* object = new juce::DynamicObject();
+    object->setProperty("name", name);
+    object->setProperty("passed", passed);
+
+    if (problem.isNotEmpty())
+        object->setProperty("problem", problem);
+
+    object->setProperty("rmsDb", rmsDb);
+    object->setProperty("peakDb", peakDb);
+    object->setProperty("spectralDb", spectralDb);
+    object->setProperty("worstSpectralDb", worstSpectralDb);
+    object->setProperty("worstFrameSeconds", worstFrameSeconds);
+    return object;
+}
+
+juce::Result GoldenCompare::readWav(const juce::File& file, juce::AudioBuffer<float>& buffer, double& sampleRate)
+{
+    if (!file.existsAsFile())
+        return juce::Result::fail("Missing reference " + file.getFullPathName());
+
+    auto stream = file.createInputStream();
+
+    if (stream == nullptr)
+        return juce::Result::fail("Could not open " + file.getFullPathName());
+
+    juce::WavAudioFormat wav;
+    std::unique_ptr<juce::AudioFormatReader> reader(wav.createReaderFor(stream.release(), true));   // Deletes the stream if it fails
+
+    if (reader == nullptr)
+        return juce::Result::fail("Could not read " + file.getFullPathName());
+
+    buffer.setSize(static_cast<int>(reader->numChannels), static_cast<int>(reader->lengthInSamples));
+    reader->read(&buffer, 0, buffer.getNumSamples(), 0, true, true);
+    sampleRate = reader->sampleRate;
+
+    return juce::Result::ok();
+}
+
+CompareResult GoldenCompare::compare(const juce::AudioBuffer<float>& rendered, const juce::AudioBuffer<float>& reference,
+                                     double sampleRate, const CompareTolerances& tolerances)
+{
+    CompareResult result;
+
+    if (rendered.getNumChannels() != reference.getNumChannels())
+    {
+        result.problem = juce::String(rendered.getNumChannels()) + " channels, reference has " + juce::String(reference.getNumChannels());
+        return result;
+    }
+
+    if (rendered.getNumSamples() != reference.getNumSamples())
+    {
+        result.problem = juce::String(rendered.getNumSamples()) + " samples, reference has " + juce::String(reference.getNumSamples());
+        return result;
+    }
+
+    const int numChannels = rendered.getNumChannels();
+    const int numSamples = rendered.getNumSamples();
+
+    // === Sample difference ===
+    double sumOfSquares = 0.0;
+    float peak = 0.0f;
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        const float* a = rendered.getReadPointer(channel);
+        const float* b = reference.getReadPointer(channel);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float diff = a[i] - b[i];
+            sumOfSquares += static_cast<double>(diff) * diff;
+            peak = juce::jmax(peak, std::abs(diff));
+        }
+    }
+
+    const double totalSamples = juce::jmax(1.0, static_cast<double>(numChannels) * numSamples);
+    result.rmsDb = juce::Decibels::gainToDecibels(std::sqrt(sumOfSquares / totalSamples), -200.0);
+    result.peakDb = juce::Decibels::gainToDecibels(static_cast<double>(peak), -200.0);
+
+    // === Log-spectral distance, frame by frame ===
+    juce::dsp::FFT fft(fftOrder);
+    juce::dsp::WindowingFunction<float> window(static_cast<size_t>(fftSize), juce::dsp::WindowingFunction<float>::hann, false);
+
+    std::vector<float> scratch(2 * fftSize);
+    std::vector<float> renderedDb(fftSize / 2), referenceDb(fftSize / 2);
+
+    double distanceSum = 0.0;
+    int numFrames = 0;
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        for (int start = 0; start < juce::jmax(1, numSamples - hopSize); start += hopSize)
+        {
+            const int length = juce::jmin(fftSize, numSamples - start);
+
+            frameSpectrum(rendered.getReadPointer(channel, start), length, fft, window, scratch, renderedDb);
+            frameSpectrum(reference.getReadPointer(channel, start), length, fft, window, scratch, referenceDb);
+
+            double squares = 0.0;
+            int numBins = 0;
+
+            for (size_t bin = 1; bin < renderedDb.size(); ++bin)
+            {
+                if (renderedDb[bin] < floorDb && referenceDb[bin] < floorDb)
+                    continue;
+
+                const double diff = renderedDb[bin] - referenceDb[bin];
+                squares += diff * diff;
+                ++numBins;
+            }
+
+            // Silent in both: nothing to compare
+            if (numBins == 0)
+                continue;
+
+            const double distance = std::sqrt(squares / numBins);
+            distanceSum += distance;
+            ++numFrames;
+
+            if (distance > result.worstSpectralDb)
+            {
+                result.worstSpectralDb = distance;
+                result.worstFrameSeconds = start / sampleRate;
+            }
+        }
+    }
+
+    result.spectralDb = numFrames > 0 ? distanceSum / numFrames : 0.0;
+    result.passed = result.rmsDb <= tolerances.maxRmsDb && result.peakDb <= tolerances.maxPeakDb
+                 && result.spectralDb <= tolerances.maxSpectralDb;
+    return result;
+}
+
+juce::AudioBuffer<float> GoldenCompare::difference(const juce::AudioBuffer<float>& rendered, const juce::AudioBuffer<float>& reference)
+{
+    const int numChannels = juce::jmin(rendered.getNumChannels(), reference.getNumChannels());
+    const int numSamples = juce::jmin(rendered.getNumSamples(), reference.getNumSamples());
+
+    juce::AudioBuffer<float> diff(numChannels, numSamples);
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        diff.copyFrom(channel, 0, rendered, channel, 0, numSamples);
+        diff.addFrom(channel, 0, reference, channel, 0, numSamples, -1.0f);
+    }
+
+    return diff;
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <juce_core/juce_core.h>
+
+
+/**
+ * @brief How far a render may drift from its reference before it counts as a regression
+ */
+struct CompareTolerances
+{
+    double maxRmsDb = -80.0;        // RMS of the difference signal, dBFS
+    double maxPeakDb = -60.0;       // Largest single sample of the difference signal, dBFS. Catches clicks the RMS averages away
+    double maxSpectralDb = 1.0;     // Mean log-spectral distance over all STFT frames, dB
+};
+
+
+/**
+ * @brief Outcome of comparing one render against its reference
+ */
+struct CompareResult
+{
+    bool passed = false;
+    juce::String problem;           // Why it failed, empty if it passed or only missed a tolerance
+
+    double rmsDb = 0.0;             // RMS of the difference, dBFS
+    double peakDb = 0.0;            // Largest single sample difference, dBFS
+    double spectralDb = 0.0;        // Mean log-spectral distance
+    double worstSpectralDb = 0.0;   // Log-spectral distance of the worst STFT frame
+    double worstFrameSeconds = 0.0; // Where that frame starts
+
+    juce::var toVar(const juce::String& name) const;
+};
+
+
+/**
+ * @brief Compares renders against stored reference renders ("golden files")
+ *
+ * The sample difference catches any change at all, the spectral distance tells audible changes
+ * (other partials, other filter curves) apart from inaudible ones like tiny phase or rounding changes.
+ * RMS and peak of the difference and the spectral distance all have to stay within their tolerance.
+ */
+namespace GoldenCompare
+{
+    juce::Result readWav(const juce::File& file, juce::AudioBuffer<float>& buffer, double& sampleRate);
+
+    CompareResult compare(const juce::AudioBuffer<float>& rendered, const juce::AudioBuffer<float>& reference,
+                          double sampleRate, const CompareTolerances& tolerances);
+
+    /**
+     * @return rendered - reference, for listening to what changed
+     */
+    juce::AudioBuffer<float> difference(const juce::AudioBuffer<float>& rendered, const juce::AudioBuffer<float>& reference);
+}
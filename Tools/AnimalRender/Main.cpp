@@ -0,0 +1,269 @@
+#include <juce_core/juce_core.h>
+#include <juce_events/juce_events.h>
+
+#include "GoldenCompare.h"
+#include "OfflineRenderer.h"
+
+#include <atomic>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+
+/**
+ * @brief Bounces MIDI files through AnimalSynth to WAV without a DAW and without any GUI
+ *
+ * Usage: AnimalRender --midi=<file.mid|folder> --output=<file.wav|folder> [--preset=<file.xml|folder>]
+ *                     [--set=<id>:<value>,...] [--rate=48000] [--block=512] [--tail=2] [--voices=<n>]
+ *                     [--bits=24] [--jobs=<n>] [--double] [--write-preset=<file.xml>]
+ *                     [--compare=<file.wav|folder>] [--max-rms-db=-80] [--max-peak-db=-60] [--max-spectral-db=1] [--report=<folder>]
+ *
+ * With a folder of MIDI files and/or a folder of presets, every combination is rendered into the output
+ * folder as <midi>_<preset>.wav, spread over --jobs threads (default: one per CPU core). A preset is the
+ * parameter XML the plugin stores as its state; --write-preset saves the defaults (plus --set) as a template.
+ * --double renders through the double precision processBlock, like a host with a 64-bit mix bus. It only
+ * exercises that code path: the result is rounded to float for the WAV, so nothing finer than float shows.
+ *
+ * With --compare, every render is checked against the reference of the same name instead of (or as well as)
+ * being written. Render the references once with a known good build, then any later build has to
+ * reproduce them within the tolerances. --report writes a JSON summary and, for every render that fails,
+ * the difference signal as <name>.diff.wav. The exit code is 1 if any render fails or misses a tolerance.
+ */
+namespace
+{
+    struct Job
+    {
+        juce::File midi;
+        juce::File preset;     // Does not exist = plugin defaults
+        juce::String name;     // Output and reference file name without .wav
+    };
+
+    juce::Array<juce::File> findFiles(const juce::File& fileOrFolder, const juce::String& wildcard)
+    {
+        if (!fileOrFolder.isDirectory())
+            return { fileOrFolder };
+
+        auto files = fileOrFolder.findChildFiles(juce::File::findFiles, false, wildcard);
+        files.sort();
+        return files;
+    }
+
+    juce::File resolve(const juce::ArgumentList& args, const juce::String& option)
+    {
+        const auto value = args.getValueForOption(option);
+        return value.isEmpty() ? juce::File() : juce::File::getCurrentWorkingDirectory().getChildFile(value);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const juce::ArgumentList args(argc, argv);
+    const juce::ScopedJuceInitialiser_GUI juceInitialiser; // Message manager only, no window is ever created
+
+    // === Settings ===
+    RenderSettings settings;
+    settings.sampleRate = args.containsOption("--rate") ? args.getValueForOption("--rate").getDoubleValue() : 48000.0;
+    settings.blockSize = args.containsOption("--block") ? args.getValueForOption("--block").getIntValue() : 512;
+    settings.tailSeconds = args.containsOption("--tail") ? args.getValueForOption("--tail").getDoubleValue() : 2.0;
+    settings.voices = args.getValueForOption("--voices").getIntValue();
+    settings.doublePrecision = args.containsOption("--double");
+
+    for (const auto& assignment : juce::StringArray::fromTokens(args.getValueForOption("--set"), ",", ""))
+        settings.overrides.set(assignment.upToFirstOccurrenceOf(":", false, false).trim(),
+                               assignment.fromFirstOccurrenceOf(":", false, false).trim());
+
+    const int bits = args.containsOption("--bits") ? args.getValueForOption("--bits").getIntValue() : 24;
+    const int numJobs = args.containsOption("--jobs") ? juce::jmax(1, args.getValueForOption("--jobs").getIntValue())
+                                                      : juce::SystemStats::getNumCpus();
+
+    if (settings.sampleRate <= 0.0 || settings.blockSize <= 0)
+    {
+        std::cerr << "Sample rate and block size must be positive" << std::endl;
+        return 1;
+    }
+
+    const juce::File presetInput = resolve(args, "--preset");
+
+    if (args.containsOption("--write-preset"))
+    {
+        const auto preset = presetInput.existsAsFile() ? juce::parseXML(presetInput) : nullptr;
+        const auto result = OfflineRenderer(settings).writePreset(resolve(args, "--write-preset"), preset.get());
+
+        if (result.failed())
+            std::cerr << result.getErrorMessage() << std::endl;
+
+        return result.wasOk() ? 0 : 1;
+    }
+
+    const juce::File midiInput = resolve(args, "--midi");
+    const juce::File output = resolve(args, "--output");
+    const juce::File references = resolve(args, "--compare");
+    const juce::File reportFolder = resolve(args, "--report");
+
+    CompareTolerances tolerances;
+    tolerances.maxRmsDb = args.containsOption("--max-rms-db") ? args.getValueForOption("--max-rms-db").getDoubleValue() : tolerances.maxRmsDb;
+    tolerances.maxPeakDb = args.containsOption("--max-peak-db") ? args.getValueForOption("--max-peak-db").getDoubleValue() : tolerances.maxPeakDb;
+    tolerances.maxSpectralDb = args.containsOption("--max-spectral-db") ? args.getValueForOption("--max-spectral-db").getDoubleValue() : tolerances.maxSpectralDb;
+
+    if (!midiInput.exists() || (output == juce::File() && !references.exists()))
+    {
+        std::cerr << "Usage: AnimalRender --midi=<file.mid|folder> --output=<file.wav|folder> [--preset=<file.xml|folder>]" << std::endl
+                  << "                    [--set=<id>:<value>,...] [--rate=48000] [--block=512] [--tail=2] [--voices=<n>]" << std::endl
+                  << "                    [--bits=24] [--jobs=<n>] [--double] [--write-preset=<file.xml>]" << std::endl
+                  << "                    [--compare=<file.wav|folder>] [--max-rms-db=-80] [--max-peak-db=-60] [--max-spectral-db=1] [--report=<folder>]" << std::endl;
+        return 1;
+    }
+
+    // === Every MIDI file with every preset ===
+    const auto midiFiles = findFiles(midiInput, "*.mid;*.midi");
+    const auto presetFiles = presetInput == juce::File() ? juce::Array<juce::File>{ juce::File() } : findFiles(presetInput, "*.xml");
+    const bool singleFile = !midiInput.isDirectory() && !presetInput.isDirectory();
+
+    std::vector<Job> jobs;
+
+    for (const auto& midi : midiFiles)
+    {
+        for (const auto& preset : presetFiles)
+        {
+            const auto name = preset.existsAsFile() ? midi.getFileNameWithoutExtension() + "_" + preset.getFileNameWithoutExtension()
+                                                    : midi.getFileNameWithoutExtension();
+
+            jobs.push_back({ midi, preset, name });
+        }
+    }
+
+    // A single render goes to (and is compared with) exactly the files given, a batch uses <name>.wav inside the folders
+    auto fileFor = [singleFile](const juce::File& fileOrFolder, const juce::String& name)
+    {
+        return singleFile && !fileOrFolder.isDirectory() ? fileOrFolder : fileOrFolder.getChildFile(name + ".wav");
+    };
+
+    if (jobs.empty())
+    {
+        std::cerr << "Nothing to render in " << midiInput.getFullPathName() << std::endl;
+        return 1;
+    }
+
+    // === Render in parallel, one processor per thread ===
+    // The processors are created here on the main thread, the threads then take jobs until none are left
+    const int numThreads = juce::jmin(numJobs, static_cast<int>(jobs.size()));
+    std::vector<std::unique_ptr<OfflineRenderer>> renderers;
+
+    for (int i = 0; i < numThreads; ++i)
+        renderers.push_back(std::make_unique<OfflineRenderer>(settings));
+
+    std::atomic<size_t> nextJob{ 0 };
+    std::atomic<int> failures{ 0 };
+    std::atomic<juce::int64> renderedSamples{ 0 };
+    std::mutex consoleLock;
+    juce::Array<juce::var> comparisons;     // Guarded by consoleLock
+
+    const auto startTime = juce::Time::getMillisecondCounterHiRes();
+
+    auto work = [&](OfflineRenderer& renderer)
+    {
+        juce::AudioBuffer<float> buffer;
+
+        for (size_t index = nextJob++; index < jobs.size(); index = nextJob++)
+        {
+            const auto& job = jobs[index];
+            const auto preset = job.preset.existsAsFile() ? juce::parseXML(job.preset) : nullptr;
+
+            auto result = job.preset.existsAsFile() && preset == nullptr
+                              ? juce::Result::fail("Could not parse " + job.preset.getFullPathName())
+                              : renderer.render(job.midi, preset.get(), buffer);
+
+            if (result.wasOk() && output != juce::File())
+                result = OfflineRenderer::writeWav(fileFor(output, job.name), buffer, settings.sampleRate, bits);
+
+            // === Golden file comparison ===
+            CompareResult comparison;
+            const bool comparing = result.wasOk() && references != juce::File();
+
+            if (comparing)
+            {
+                juce::AudioBuffer<float> reference;
+                double referenceRate = 0.0;
+                const auto read = GoldenCompare::readWav(fileFor(references, job.name), reference, referenceRate);
+
+                if (read.failed())
+                    comparison.problem = read.getErrorMessage();
+                else if (referenceRate != settings.sampleRate)
+                    comparison.problem = "Reference has " + juce::String(referenceRate) + " Hz";
+                else
+                    comparison = GoldenCompare::compare(buffer, reference, settings.sampleRate, tolerances);
+
+                if (!comparison.passed && reportFolder != juce::File() && reference.getNumSamples() > 0)
+                    OfflineRenderer::writeWav(reportFolder.getChildFile(job.name + ".diff.wav"), GoldenCompare::difference(buffer, reference),
+                                              settings.sampleRate, 32);
+            }
+
+            const std::lock_guard<std::mutex> lock(consoleLock);
+
+            if (result.failed())
+            {
+                ++failures;
+                std::cerr << result.getErrorMessage() << std::endl;
+                continue;
+            }
+
+            renderedSamples += buffer.getNumSamples();
+
+            if (!comparing)
+            {
+                std::cout << job.name << ": " << juce::String(buffer.getNumSamples() / settings.sampleRate, 2) << " s" << std::endl;
+                continue;
+            }
+
+            comparisons.add(comparison.toVar(job.name));
+            failures += comparison.passed ? 0 : 1;
+
+            std::cout << (comparison.passed ? "PASS " : "FAIL ") << job.name;
+
+            if (comparison.problem.isNotEmpty())
+                std::cout << ": " << comparison.problem << std::endl;
+            else
+                std::cout << ": difference " << juce::String(comparison.rmsDb, 1) << " dB RMS, " << juce::String(comparison.peakDb, 1)
+                          << " dB peak, spectral distance " << juce::String(comparison.spectralDb, 2) << " dB (worst "
+                          << juce::String(comparison.worstSpectralDb, 2) << " dB at " << juce::String(comparison.worstFrameSeconds, 2) << " s)" << std::endl;
+        }
+    };
+
+    std::vector<std::thread> threads;
+
+    for (auto& renderer : renderers)
+        threads.emplace_back(work, std::ref(*renderer));
+
+    for (auto& thread : threads)
+        thread.join();
+
+    const double elapsed = (juce::Time::getMillisecondCounterHiRes() - startTime) / 1000.0;
+    const double audioSeconds = static_cast<double>(renderedSamples.load()) / settings.sampleRate;
+
+    std::cout << jobs.size() - static_cast<size_t>(failures.load()) << " of " << jobs.size() << (references != juce::File() ? " passed, " : " files, ")
+              << juce::String(audioSeconds, 1) << " s of audio in " << juce::String(elapsed, 2) << " s ("
+              << juce::String(audioSeconds / juce::jmax(elapsed, 1.0e-6), 1) << "x real time, " << numThreads << " threads)" << std::endl;
+
+    if (reportFolder != juce::File() && references != juce::File())
+    {
+        auto* report = new juce::DynamicObject();
+        report->setProperty("maxRmsDb", tolerances.maxRmsDb);
+        report->setProperty("maxPeakDb", tolerances.maxPeakDb);
+        report->setProperty("maxSpectralDb", tolerances.maxSpectralDb);
+        report->setProperty("failures", failures.load());
+        report->setProperty("results", comparisons);
+
+        reportFolder.createDirectory();
+        reportFolder.getChildFile("report.json").replaceWithText(juce::JSON::toString(juce::var(report)));
+    }
+
+   #if ANIMALSYNTH_RT_CHECKS
+    if (RealtimeSafety::getNumViolations() > 0)
+    {
+        std::cerr << RealtimeSafety::getNumViolations() << " real-time safety violations inside processBlock" << std::endl;
+        return 1;
+    }
+   #endif
+
+    return failures.load() == 0 ? 0 : 1;
+}
@@ -0,0 +1,179 @@
+#include "OfflineRenderer.h"
+
+#include <cmath>
+#include <type_traits>
+
+
+OfflineRenderer::OfflineRenderer(const RenderSettings& settingsToUse)
+    : settings(settingsToUse)
+{
+    if (settings.voices > 0)
+        processor.setVoiceCount(settings.voices);
+
+    processor.setNonRealtime(true);
+    processor.setProcessingPrecision(settings.doublePrecision ? juce::AudioProcessor::doublePrecision
+                                                              : juce::AudioProcessor::singlePrecision);
+    processor.setRateAndBufferSizeDetails(settings.sampleRate, settings.blockSize);
+}
+
+juce::Result OfflineRenderer::render(const juce::File& midiFile, const juce::XmlElement* preset, juce::AudioBuffer<float>& output)
+{
+    // === Read and merge the MIDI tracks ===
+    juce::FileInputStream stream(midiFile);
+    juce::MidiFile midi;
+
+    if (!stream.openedOk() || !midi.readFrom(stream))
+        return juce::Result::fail("Could not read " + midiFile.getFullPathName());
+
+    midi.convertTimestampTicksToSeconds();
+
+    juce::MidiMessageSequence sequence;
+
+    for (int track = 0; track < midi.getNumTracks(); ++track)
+        sequence.addSequence(*midi.getTrack(track), 0.0);
+
+    const auto applied = applyParameters(preset);
+
+    if (applied.failed())
+        return applied;
+
+    processor.prepareToPlay(settings.sampleRate, settings.blockSize);
+
+    const int totalSamples = static_cast<int>(std::ceil((sequence.getEndTime() + settings.tailSeconds) * settings.sampleRate));
+    output.setSize(processor.getTotalNumOutputChannels(), totalSamples);
+
+    if (settings.doublePrecision)
+        renderBlocks<double>(sequence, output);
+    else
+        renderBlocks<float>(sequence, output);
+
+    processor.releaseResources();
+    return juce::Result::ok();
+}
+
+/**
+ * @brief Plays the sequence through the prepared processor, block by block, and fills the output.
+ *
+ * @param output Already sized to the output channels and the full length of the render
+ */
+template <typename SampleType>
+void OfflineRenderer::renderBlocks(const juce::MidiMessageSequence& sequence, juce::AudioBuffer<float>& output)
+{
+    const double sampleRate = settings.sampleRate;
+    const int blockSize = settings.blockSize;
+    const int numChannels = output.getNumChannels();
+    const int totalSamples = output.getNumSamples();
+
+    juce::AudioBuffer<SampleType> block(numChannels, blockSize);
+    juce::MidiBuffer midiBlock;
+    int nextEvent = 0;
+
+    for (int start = 0; start < totalSamples; start += blockSize)
+    {
+        const int numSamples = juce::jmin(blockSize, totalSamples - start);
+
+        midiBlock.clear();
+
+        for (; nextEvent < sequence.getNumEvents(); ++nextEvent)
+        {
+            const auto& message = sequence.getEventPointer(nextEvent)->message;
+            const int position = juce::roundToInt(message.getTimeStamp() * sampleRate);
+
+            if (position >= start + numSamples)
+                break;
+
+            if (!message.isMetaEvent())
+                midiBlock.addEvent(message, juce::jmax(0, position - start));
+        }
+
+        // Same channel pointers, but only as long as this block
+        juce::AudioBuffer<SampleType> view(block.getArrayOfWritePointers(), numChannels, numSamples);
+        view.clear();
+
+        processor.processBlock(view, midiBlock);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            if constexpr (std::is_same_v<SampleType, float>)
+            {
+                output.copyFrom(channel, start, view, channel, 0, numSamples);
+            }
+            else
+            {
+                const SampleType* source = view.getReadPointer(channel);
+                float* destination = output.getWritePointer(channel, start);
+
+                for (int i = 0; i < numSamples; ++i)
+                    destination[i] = static_cast<float>(source[i]);
+            }
+        }
+    }
+}
+
+juce::Result OfflineRenderer::writePreset(const juce::File& file, const juce::XmlElement* preset)
+{
+    const auto applied = applyParameters(preset);
+
+    if (applied.failed())
+        return applied;
+
+    const auto xml = processor.parameters.copyState().createXml();
+
+    if (xml == nullptr || !xml->writeTo(file))
+        return juce::Result::fail("Could not write " + file.getFullPathName());
+
+    return juce::Result::ok();
+}
+
+juce::Result OfflineRenderer::writeWav(const juce::File& file, const juce::AudioBuffer<float>& buffer, double sampleRate, int bitsPerSample)
+{
+    file.getParentDirectory().createDirectory();
+    file.deleteFile();
+
+    auto stream = std::make_unique<juce::FileOutputStream>(file);
+
+    if (stream->failedToOpen())
+        return juce::Result::fail("Could not write " + file.getFullPathName());
+
+    juce::WavAudioFormat wav;
+    std::unique_ptr<juce::AudioFormatWriter> writer(wav.createWriterFor(stream.get(), sampleRate,
+                                                                        static_cast<unsigned int>(buffer.getNumChannels()),
+                                                                        bitsPerSample, {}, 0));
+
+    if (writer == nullptr)
+        return juce::Result::fail("Unsupported WAV format: " + juce::String(bitsPerSample) + " bit");
+
+    stream.release(); // Owned by the writer now
+
+    if (!writer->writeFromAudioSampleBuffer(buffer, 0, buffer.getNumSamples()))
+        return juce::Result::fail("Could not write " + file.getFullPathName());
+
+    return juce::Result::ok();
+}
+
+/**
+ * @brief Resets every parameter to its default, then applies the preset and the overrides on top.
+ */
+juce::Result OfflineRenderer::applyParameters(const juce::XmlElement* preset)
+{
+    for (auto* parameter : processor.getParameters())
+        parameter->setValueNotifyingHost(parameter->getDefaultValue());
+
+    if (preset != nullptr && !processor.loadPreset(*preset))
+        return juce::Result::fail("Not an AnimalSynth preset: <" + preset->getTagName() + ">");
+
+    const auto& keys = settings.overrides.getAllKeys();
+
+    for (int i = 0; i < keys.size(); ++i)
+    {
+        auto* parameter = processor.parameters.getParameter(keys[i]);
+
+        if (parameter == nullptr)
+            return juce::Result::fail("Unknown parameter: " + keys[i]);
+
+        const float value = settings.overrides[keys[i]].getFloatValue();
+        parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+    }
+
+    return juce::Result::ok();
+}
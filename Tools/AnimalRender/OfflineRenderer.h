@@ -0,0 +1,61 @@
+#pragma once
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <juce_core/juce_core.h>
+
+#include "../../Source/PluginProcessor.h"
+
+
+/**
+ * @brief How every file of a batch is rendered
+ */
+struct RenderSettings
+{
+    double sampleRate = 48000.0;
+    int blockSize = 512;
+    double tailSeconds = 2.0;           // Rendered after the last MIDI event, so releases ring out
+    int voices = 0;                     // 0 = the plugin's default
+    bool doublePrecision = false;       // Renders through the double processBlock, the output is still rounded to float
+    juce::StringPairArray overrides;    // Parameter ID -> plain value, applied on top of the preset
+};
+
+
+/**
+ * @brief Renders MIDI files through its own AnimalSynthAudioProcessor, without an editor and as fast as possible
+ *
+ * Each instance is meant to be used by one thread at a time. For parallel rendering, create one per thread;
+ * the processors share nothing but the read-only wavetable and minBLEP tables.
+ */
+class OfflineRenderer
+{
+public:
+    explicit OfflineRenderer(const RenderSettings& settingsToUse);
+
+    /**
+     * @brief Renders a standard MIDI file with a preset.
+     *
+     * All tracks are merged. The processor is prepared from scratch for every file, so nothing from the
+     * previous render carries over.
+     *
+     * @param midiFile The .mid file to play
+     * @param preset An XML preset, or nullptr for the plugin defaults
+     * @param output Resized to the output channels and the length of the MIDI file plus the tail
+     */
+    juce::Result render(const juce::File& midiFile, const juce::XmlElement* preset, juce::AudioBuffer<float>& output);
+
+    /**
+     * @brief Writes the parameters the next render would use, so they can be edited and used as a preset.
+     */
+    juce::Result writePreset(const juce::File& file, const juce::XmlElement* preset);
+
+    static juce::Result writeWav(const juce::File& file, const juce::AudioBuffer<float>& buffer, double sampleRate, int bitsPerSample);
+
+private:
+    juce::Result applyParameters(const juce::XmlElement* preset);
+
+    template <typename SampleType>
+    void renderBlocks(const juce::MidiMessageSequence& sequence, juce::AudioBuffer<float>& output);
+
+    RenderSettings settings;
+    AnimalSynthAudioProcessor processor;
+};
@@ -0,0 +1,86 @@
+#include <juce_core/juce_core.h>
+#include <juce_graphics/juce_graphics.h>
+
+#include "../../Source/AnimationFormat.h"
+
+#include <iostream>
+
+
+/**
+ * @brief Build-time tool that turns assets/<animal>/<animal>_<n>.png into a single <animal>.anim
+ *
+ * Usage: AssetPacker --input=<folder> --name=<animal> --output=<file.anim> [--fit=<width>x<height>]
+ *
+ * With --fit, every frame is scaled down to fit within the given size first, so the plugin only
+ * ships the pixels it can actually show.
+ */
+int main(int argc, char* argv[])
+{
+    const juce::ArgumentList args(argc, argv);
+
+    const juce::File input = juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption("--input"));
+    const juce::File output = juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption("--output"));
+    const juce::String name = args.getValueForOption("--name");
+    const juce::String fit = args.getValueForOption("--fit");
+
+    if (!input.isDirectory() || name.isEmpty() || args.getValueForOption("--output").isEmpty())
+    {
+        std::cerr << "Usage: AssetPacker --input=<folder> --name=<animal> --output=<file.anim> [--fit=<width>x<height>]" << std::endl;
+        return 1;
+    }
+
+    const int maxWidth = fit.upToFirstOccurrenceOf("x", false, false).getIntValue();
+    const int maxHeight = fit.fromFirstOccurrenceOf("x", false, false).getIntValue();
+
+    // === Decode and scale the frames ===
+    std::vector<juce::Image> frames;
+
+    for (int index = 0;; ++index)
+    {
+        const juce::File file = input.getChildFile(name + "_" + juce::String(index) + ".png");
+
+        if (!file.existsAsFile())
+            break;
+
+        juce::Image frame = juce::ImageFileFormat::loadFrom(file);
+
+        if (!frame.isValid())
+        {
+            std::cerr << "Could not decode " << file.getFullPathName() << std::endl;
+            return 1;
+        }
+
+        if (maxWidth > 0 && maxHeight > 0 && (frame.getWidth() > maxWidth || frame.getHeight() > maxHeight))
+        {
+            const auto fitted = juce::RectanglePlacement(juce::RectanglePlacement::centred | juce::RectanglePlacement::onlyReduceInSize)
+                                    .appliedTo(frame.getBounds(), juce::Rectangle<int>(maxWidth, maxHeight));
+
+            frame = frame.rescaled(juce::jmax(1, fitted.getWidth()), juce::jmax(1, fitted.getHeight()), juce::Graphics::highResamplingQuality);
+        }
+
+        frames.push_back(frame.convertedToFormat(juce::Image::ARGB));
+    }
+
+    if (frames.empty())
+    {
+        std::cerr << "No frames named " << name << "_<n>.png in " << input.getFullPathName() << std::endl;
+        return 1;
+    }
+
+    // === Encode ===
+    output.getParentDirectory().createDirectory();
+    output.deleteFile();
+
+    juce::FileOutputStream stream(output);
+
+    if (stream.failedToOpen() || !AnimationFormat::write(stream, frames))
+    {
+        std::cerr << "Could not write " << output.getFullPathName() << std::endl;
+        return 1;
+    }
+
+    stream.flush();
+    std::cout << name << ": " << frames.size() << " frames, " << frames.front().getWidth() << "x" << frames.front().getHeight()
+              << ", " << stream.getPosition() << " bytes" << std::endl;
+    return 0;
+}